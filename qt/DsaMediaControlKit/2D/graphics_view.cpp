@@ -3,16 +3,25 @@
 #include <QDebug>
 #include <QJsonArray>
 #include <QMimeData>
+#include <QElapsedTimer>
 
 #include "player_tile.h"
 #include "playlist_player_tile.h"
 #include "misc/json_mime_data_parser.h"
+#include "misc/sound_file_mime_data.h"
 
 namespace TwoD {
 
 GraphicsView::GraphicsView(QGraphicsScene *scene, QWidget *parent)
     : QGraphicsView(scene, parent)
     , model_(0)
+    , tile_grid_()
+    , key_tiles_()
+    , key_timer_()
+    , key_dispatching_(false)
+    , key_dispatch_count_(0)
+    , key_dispatch_total_ns_(0)
+    , key_dispatch_max_ns_(0)
 {
     setScene(scene);
     setAcceptDrops(true);
@@ -22,12 +31,26 @@ GraphicsView::GraphicsView(QGraphicsScene *scene, QWidget *parent)
 GraphicsView::GraphicsView(QWidget *parent)
     : QGraphicsView(parent)
     , model_(0)
+    , tile_grid_()
+    , key_tiles_()
+    , key_timer_()
+    , key_dispatching_(false)
+    , key_dispatch_count_(0)
+    , key_dispatch_total_ns_(0)
+    , key_dispatch_max_ns_(0)
 {
     setScene(new QGraphicsScene(QRectF(0,0,100,100),this));
     scene()->setSceneRect(0,0, 100, 100);
     setAcceptDrops(true);
 }
 
+GraphicsView::~GraphicsView()
+{
+    // scene may outlive view
+    foreach(Tile* t, tile_grid_.getTiles())
+        t->setTileGrid(0);
+}
+
 const QJsonObject GraphicsView::toJsonObject() const
 {
     QJsonObject obj;
@@ -62,6 +85,9 @@ const QJsonObject GraphicsView::toJsonObject() const
 
 bool GraphicsView::setFromJsonObject(const QJsonObject &obj)
 {
+    QElapsedTimer timer;
+    timer.start();
+
     if(obj.isEmpty() || !obj.contains("scene"))
         return false;
     if(!obj["scene"].isObject())
@@ -85,7 +111,9 @@ bool GraphicsView::setFromJsonObject(const QJsonObject &obj)
 
     clearTiles();
 
-    // tiles
+    // parse tile descriptions
+    QList<QJsonObject> tile_objs;
+    int entry_count = 0;
     QJsonArray arr_tiles = sc_obj["tiles"].toArray();
     foreach(QJsonValue val, arr_tiles) {
         if(!val.isObject())
@@ -94,24 +122,50 @@ bool GraphicsView::setFromJsonObject(const QJsonObject &obj)
         if(!t_obj.contains("type") || !t_obj.contains("data") || !t_obj["data"].isObject())
             continue;
 
-        // create tile, if type is TwoD::PlaylistPlayerTile
-        if(t_obj["type"].toString().compare("TwoD::PlaylistPlayerTile") == 0) {
-            PlaylistPlayerTile* tile = new PlaylistPlayerTile;
-            tile->setSoundFileModel(model_);
-            tile->setFlag(QGraphicsItem::ItemIsMovable, true);
-            tile->init();
-            if(tile->setFromJsonObject(t_obj["data"].toObject())) {
-               scene()->addItem(tile);
-            }
-            else {
-                qDebug() << "FAILURE: Could not set Tile data from JSON.";
-                qDebug() << " > data:" << t_obj["data"];
-                qDebug() << " > Aborting.";
-                delete tile;
-                return false;
-            }
+        // only type TwoD::PlaylistPlayerTile is created
+        if(t_obj["type"].toString().compare("TwoD::PlaylistPlayerTile") != 0)
+            continue;
+
+        QJsonObject data = t_obj["data"].toObject();
+        tile_objs.append(data);
+        entry_count += data["playlist"].toArray().size();
+    }
+    qint64 parse_ns = timer.nsecsElapsed();
+    timer.restart();
+
+    // create tiles, sound files are looked up in the index of the model
+    QList<PlaylistPlayerTile*> key_tiles;
+    foreach(QJsonObject const& data, tile_objs) {
+        PlaylistPlayerTile* tile = new PlaylistPlayerTile;
+        tile->setSoundFileModel(model_);
+        tile->setFlag(QGraphicsItem::ItemIsMovable, true);
+        tile->init();
+        if(tile->setFromJsonObject(data)) {
+           scene()->addItem(tile);
+           registerTile(tile);
+           if(tile->hasActivateKey())
+               key_tiles.append(tile);
+        }
+        else {
+            qDebug() << "FAILURE: Could not set Tile data from JSON.";
+            qDebug() << " > data:" << data;
+            qDebug() << " > Aborting.";
+            delete tile;
+            return false;
         }
     }
+    qint64 build_ns = timer.nsecsElapsed();
+    timer.restart();
+
+    // decode sounds of key bound tiles, before the first key press
+    foreach(PlaylistPlayerTile* tile, key_tiles)
+        tile->preload();
+    qint64 preload_ns = timer.nsecsElapsed();
+
+    qDebug() << "NOTIFICATION: Scene set from JSON," << tile_objs.size() << "tiles,"
+             << entry_count << "playlist entries";
+    qDebug() << " > parse:" << parse_ns / 1e6
+             << "ms, create tiles:" << build_ns / 1e6 << "ms, start preload:" << preload_ns / 1e6 << "ms";
 
     return true;
 }
@@ -166,25 +220,50 @@ void GraphicsView::dropEvent(QDropEvent *event)
 
     QPointF p(mapToScene(event->pos()));
 
-    foreach(QGraphicsItem* item, scene()->items()){
-        if (item->contains(item->mapFromScene(p))){
-            QObject *selected_object = dynamic_cast<QObject*>(item);
-            if(selected_object)
-            {
-                Tile* t = qobject_cast<Tile*>(selected_object);
-                if(t){
-                    t->receiveExternalData(event->mimeData());
-                    return;
-                }
-            }
+    Tile* target = tile_grid_.tileAt(p);
+    if(target) {
+        target->receiveExternalData(event->mimeData());
+        return;
+    }
+
+    // sound files dragged within this program, no parsing required
+    QList<int> ids = Misc::SoundFileMimeData::toIds(event->mimeData());
+    if(!ids.isEmpty()) {
+        QElapsedTimer timer;
+        timer.start();
+
+        DB::SoundFileRecord* first = model_ ? model_->getSoundFileById(ids.first()) : 0;
+        if(first == 0) {
+            event->ignore();
+            return;
         }
+
+        PlaylistPlayerTile* tile = new PlaylistPlayerTile;
+        tile->setSoundFileModel(model_);
+        tile->setFlag(QGraphicsItem::ItemIsMovable, true);
+        tile->setName(first->name);
+        tile->init();
+        tile->setPos(p);
+        tile->setSize(0);
+        tile->addMedia(ids);
+
+        scene()->addItem(tile);
+        registerTile(tile);
+        tile->setSmallSize();
+
+        event->setDropAction(Qt::CopyAction);
+        event->accept();
+
+        qDebug() << "NOTIFICATION: Dropped" << ids.size() << "sound files into new tile";
+        qDebug() << " > drop:" << timer.nsecsElapsed() / 1e6 << "ms";
+        return;
     }
 
-    // extract DB::TableRecord from mime data
-    QList<DB::TableRecord*> records = Misc::JsonMimeDataParser::toTableRecordList(event->mimeData());
+    // extract sound files from mime data
+    QVector<DB::SoundFileRecord> records = Misc::JsonMimeDataParser::toSoundFileRecords(event->mimeData());
 
     // validate parsing
-    if(records.size() == 0 || records[0]->index != DB::SOUND_FILE) {
+    if(records.size() == 0) {
         event->ignore();
         return;
     }
@@ -193,46 +272,50 @@ void GraphicsView::dropEvent(QDropEvent *event)
     PlaylistPlayerTile* tile = new PlaylistPlayerTile;
     tile->setSoundFileModel(model_);
     tile->setFlag(QGraphicsItem::ItemIsMovable, true);
-    tile->setName(records[0]->name);
+    tile->setName(records[0].name);
     tile->init();
     tile->setPos(p);
     tile->setSize(0);
 
-    foreach(DB::TableRecord* rec, records) {
-        if(rec->index == DB::SOUND_FILE)
-            tile->addMedia(*((DB::SoundFileRecord*) rec));
-    }
+    QList<int> record_ids;
+    foreach(DB::SoundFileRecord const& rec, records)
+        record_ids.append(rec.id);
+    tile->addMedia(record_ids);
 
     // add to scene
     scene()->addItem(tile);
+    registerTile(tile);
     tile->setSmallSize();
 
     // except event
     event->setDropAction(Qt::CopyAction);
     event->accept();
-
-    // delete temp records
-    while(records.size() > 0) {
-        delete records[0];
-        records.pop_front();
-    }
 }
 
-void GraphicsView::keyPressEvent(QKeyEvent*)
+void GraphicsView::keyPressEvent(QKeyEvent *event)
 {
-    //qDebug() << event->key();
-}
+    QHash<int, QList<Tile*> >::const_iterator it = key_tiles_.constFind(event->key());
+    if(it == key_tiles_.constEnd()) {
+        QGraphicsView::keyPressEvent(event);
+        return;
+    }
 
-void GraphicsView::keyReleaseEvent(QKeyEvent *event)
-{
-    foreach(QGraphicsItem* it, scene()->items()) {
-        QObject* o = dynamic_cast<QObject*>(it);
-        if(o) {
-            Tile* t = qobject_cast<Tile*>(o);
-            if(t->hasActivateKey() && t->getActivateKey() == event->key())
-                t->onActivate();
-        }
+    event->accept();
+    if(event->isAutoRepeat())
+        return;
+
+    key_timer_.start();
+    key_dispatching_ = true;
+
+    // copy, activation may change key bindings
+    QList<Tile*> tiles = it.value();
+    foreach(Tile* t, tiles) {
+        // deleted tiles leave the scene before they get destroyed
+        if(t->scene() == scene())
+            t->onActivate();
     }
+
+    key_dispatching_ = false;
 }
 
 void GraphicsView::wheelEvent(QWheelEvent *event)
@@ -242,22 +325,81 @@ void GraphicsView::wheelEvent(QWheelEvent *event)
 
     QPointF p(mapToScene(event->pos()));
 
-    foreach(QGraphicsItem* item, scene()->items()){
-        if (item->contains(item->mapFromScene(p))){
-            QObject *selected_object = dynamic_cast<QObject*>(item);
-            if(selected_object)
-            {
-                Tile* t = qobject_cast<Tile*>(selected_object);
-                if(t){
-                    t->receiveWheelEvent(event);
-                    return;
-                }
-            }
-        }
+    Tile* t = tile_grid_.tileAt(p);
+    if(t) {
+        t->receiveWheelEvent(event);
+        return;
     }
     QGraphicsView::wheelEvent(event);
 }
 
+void GraphicsView::onTileKeyChanged(QChar previous)
+{
+    Tile* t = qobject_cast<Tile*>(sender());
+    if(!t)
+        return;
+
+    QHash<int, QList<Tile*> >::iterator it = key_tiles_.find(previous.unicode());
+    if(it != key_tiles_.end()) {
+        it.value().removeOne(t);
+        if(it.value().isEmpty())
+            key_tiles_.erase(it);
+    }
+
+    if(t->hasActivateKey())
+        key_tiles_[t->getActivateKey().unicode()].append(t);
+}
+
+void GraphicsView::onTileDestroyed(QObject *obj)
+{
+    // tile is already destroyed, only its address is used
+    Tile* t = static_cast<Tile*>(obj);
+
+    QHash<int, QList<Tile*> >::iterator it = key_tiles_.begin();
+    while(it != key_tiles_.end()) {
+        it.value().removeOne(t);
+        if(it.value().isEmpty())
+            it = key_tiles_.erase(it);
+        else
+            ++it;
+    }
+}
+
+void GraphicsView::onTileAboutToPlay()
+{
+    if(!key_dispatching_)
+        return;
+
+    qint64 ns = key_timer_.nsecsElapsed();
+    ++key_dispatch_count_;
+    key_dispatch_total_ns_ += ns;
+    key_dispatch_max_ns_ = qMax(key_dispatch_max_ns_, ns);
+
+    qDebug() << "NOTIFICATION: Key press dispatched to play() in" << ns / 1000.0 << "us";
+    qDebug() << " > Mean:" << key_dispatch_total_ns_ / (1000.0 * key_dispatch_count_)
+             << "us, max:" << key_dispatch_max_ns_ / 1000.0 << "us over" << key_dispatch_count_ << "presses";
+
+    if(ns > 1000000)
+        qDebug() << "FAILURE: Key press dispatch exceeded 1 ms";
+}
+
+void GraphicsView::registerTile(Tile *tile)
+{
+    tile->setTileGrid(&tile_grid_);
+
+    connect(tile, SIGNAL(activateKeyChanged(QChar)),
+            this, SLOT(onTileKeyChanged(QChar)));
+    connect(tile, SIGNAL(destroyed(QObject*)),
+            this, SLOT(onTileDestroyed(QObject*)));
+    connect(tile, SIGNAL(aboutToPlay()),
+            this, SLOT(onTileAboutToPlay()));
+
+    if(tile->hasActivateKey())
+        key_tiles_[tile->getActivateKey().unicode()].append(tile);
+
+    emit tileAdded(tile);
+}
+
 void GraphicsView::clearTiles()
 {
     foreach(QGraphicsItem* it, scene()->items()) {
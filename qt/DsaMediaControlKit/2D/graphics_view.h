@@ -4,8 +4,13 @@
 #include <QGraphicsView>
 #include <QMouseEvent>
 #include <QJsonObject>
+#include <QHash>
+#include <QList>
+#include <QElapsedTimer>
 
 #include "db/model/sound_file_table_model.h"
+#include "tile.h"
+#include "tile_grid.h"
 
 // TODO: rename namespace to Tile
 namespace TwoD {
@@ -16,6 +21,8 @@ namespace TwoD {
  * Evaulates drops, instanciating derived Tile objects.
  * Implements bahavior for adapting screen size to widget resize.
  * Implements forwarding of drops to colliding Tile instances.
+ * Dispatches key presses to tiles with matching activate key.
+ * Keeps a spatial index of all tiles for hit-testing and collision.
  * Holds functionality to convert all tiles in scene to JSON description
  * and be set from JSON.
 */
@@ -26,6 +33,7 @@ class GraphicsView : public QGraphicsView
 public:
     GraphicsView(QGraphicsScene *scene, QWidget *parent);
     GraphicsView(QWidget *parent);
+    ~GraphicsView();
 
     /**
      * Parses all tiles in scene to JSON object.
@@ -42,6 +50,20 @@ public:
     void setSoundFileModel(DB::Model::SoundFileTableModel* m);
     DB::Model::SoundFileTableModel* getSoundFileModel();
 
+signals:
+    /** tile has been added to scene */
+    void tileAdded(TwoD::Tile* tile);
+
+private slots:
+    /** updates key dispatch table for re-keyed tile (sender) */
+    void onTileKeyChanged(QChar previous);
+
+    /** removes deleted tile from key dispatch table */
+    void onTileDestroyed(QObject* obj);
+
+    /** measures time from key press to playback of tile */
+    void onTileAboutToPlay();
+
 private:
     /**
      * Handle scene size when widget resizes.
@@ -67,8 +89,12 @@ private:
     * Drops are forwarded to Tile containing mouse position.
     */
     void dropEvent(QDropEvent *event);
+
+    /**
+    * Activates all tiles bound to pressed key.
+    * Auto repeated presses are ignored, so holding a key does not toggle tiles.
+    */
     void keyPressEvent(QKeyEvent *event);
-    void keyReleaseEvent(QKeyEvent *event);
 
     virtual void wheelEvent(QWheelEvent *event);
 
@@ -77,7 +103,25 @@ private:
      */
     void clearTiles();
 
+    /**
+     * Tracks tile added to scene in spatial index and key dispatch table.
+    */
+    void registerTile(Tile* tile);
+
     DB::Model::SoundFileTableModel* model_;
+
+    // spatial index of tiles in scene
+    TileGrid tile_grid_;
+
+    // tiles by activate key (unicode of key), for dispatch without scanning scene
+    QHash<int, QList<Tile*> > key_tiles_;
+
+    // key press dispatch measurement
+    QElapsedTimer key_timer_;
+    bool key_dispatching_;
+    int key_dispatch_count_;
+    qint64 key_dispatch_total_ns_;
+    qint64 key_dispatch_max_ns_;
 };
 
 }
@@ -19,25 +19,16 @@ PlayerTile::~PlayerTile()
 
 void PlayerTile::paint(QPainter *painter, const QStyleOptionGraphicsItem*, QWidget*)
 {
-    scene()->update(scene()->sceneRect());
-
-    setDefaultOpacity();
-
     QRectF p_rect = getPaintRect();
 
     // paint
     painter->fillRect(p_rect, getBackgroundBrush());
     if(p_rect.width() > 0 && p_rect.height() > 0) {
-        painter->drawPixmap(
-            (int) p_rect.x(),
-            (int)p_rect.y(),
-            (int)p_rect.width(),
-            (int)p_rect.height(),
-            getPlayStatePixmap()
-        );
+        QRect rect = p_rect.toRect();
+        painter->drawPixmap(rect.topLeft(), getScaledPixmap(getPlayStatePixmap(), rect.size()));
     }
     if(mode_ == HOVER)
-        painter->drawText(QPointF(p_rect.x(), p_rect.y()-5), name_);
+        paintName(painter);
 }
 
 void PlayerTile::setMedia(const QMediaContent &c)
@@ -48,8 +39,9 @@ void PlayerTile::setMedia(const QMediaContent &c)
 void PlayerTile::play()
 {
     if(!player_->media().isNull() && !is_playing_) {
+        emit aboutToPlay();
         player_->play();
-        is_playing_ = true;
+        setPlaying(true);
     }
 }
 
@@ -57,7 +49,7 @@ void PlayerTile::stop()
 {
     if(!player_->media().isNull() && is_playing_) {
         player_->stop();
-        is_playing_ = false;
+        setPlaying(false);
     }
 }
 
@@ -73,12 +65,21 @@ void PlayerTile::mouseReleaseEvent(QGraphicsSceneMouseEvent *e)
     Tile::mouseReleaseEvent(e);
 }
 
-const QPixmap PlayerTile::getPlayStatePixmap() const
+const QPixmap* PlayerTile::getPlayStatePixmap() const
 {
     if(is_playing_)
-        return *Resources::PX_STOP;
+        return Resources::PX_STOP;
     else
-        return *Resources::PX_PLAY;
+        return Resources::PX_PLAY;
+}
+
+void PlayerTile::setPlaying(bool playing)
+{
+    if(is_playing_ == playing)
+        return;
+
+    is_playing_ = playing;
+    update(getPaintRect());
 }
 
 } // namespace TwoD
@@ -34,7 +34,12 @@ protected:
     /**
      * Returns QPixmap image based on the playback state.
     */
-    virtual const QPixmap getPlayStatePixmap() const;
+    virtual const QPixmap* getPlayStatePixmap() const;
+
+    /**
+     * Sets playback state, repaints play state image only.
+    */
+    void setPlaying(bool playing);
 
     QMediaPlayer* player_;
     bool is_playing_;
@@ -5,8 +5,11 @@
 #include <QDebug>
 #include <QMenu>
 #include <QJsonArray>
+#include <QElapsedTimer>
 
 #include "sound_file/list_view_dialog.h"
+#include "misc/sound_file_mime_data.h"
+#include "audio/pcm_cache.h"
 
 using namespace Playlist;
 
@@ -19,24 +22,29 @@ PlaylistPlayerTile::PlaylistPlayerTile(QGraphicsItem *parent)
     , playlist_(0)
     , model_(0)
     , is_playing_(false)
+    , instant_(false)
+    , instant_action_(0)
+    , pinned_paths_()
 {
-    player_ = new CustomMediaPlayer(this);
-    //connect(player_, SIGNAL(stateChanged(QMediaPlayer::State)),
-    //        this, SLOT(changePlayerState(QMediaPlayer::State)));
-
-    connect(this, SIGNAL(wheelChangedVolume(int)),
-            player_, SLOT(mediaVolumeChanged(int)) );
+    // player gets created on first activation (see getPlayer())
+    playlist_ = new Playlist::Playlist("Playlist");
+    playlist_->setRandomStream(getUuid().toString());
 
-    connect(player_, SIGNAL(toggledPlayerActivation(bool)),
-            this, SLOT(changedCustomPlayerActivation(bool)) );
+    connect(playlist_, SIGNAL(mediaInserted(int,int)),
+            this, SLOT(onPlaylistChanged()));
+    connect(playlist_, SIGNAL(mediaRemoved(int,int)),
+            this, SLOT(onPlaylistChanged()));
+    connect(playlist_, SIGNAL(changedSettings()),
+            this, SIGNAL(changed()));
 
-    playlist_ = new Playlist::Playlist("Playlist");
-    player_->setPlaylist(playlist_);
     setAcceptDrops(true);
 }
 
 PlaylistPlayerTile::~PlaylistPlayerTile()
 {
+    foreach(QString const& path, pinned_paths_)
+        Audio::PcmCache::instance()->unpin(path);
+
     delete playlist_;
     playlist_ = 0;
 }
@@ -48,18 +56,11 @@ void PlaylistPlayerTile::paint(QPainter *painter, const QStyleOptionGraphicsItem
 
     QRectF p_rect(getPaintRect());
     if(p_rect.width() > 0 && p_rect.height() > 0) {
-        painter->drawPixmap(
-            (int) p_rect.x(),
-            (int)p_rect.y(),
-            (int)p_rect.width(),
-            (int)p_rect.height(),
-            getPlayStatePixmap()
-        );
+        QRect rect = p_rect.toRect();
+        painter->drawPixmap(rect.topLeft(), getScaledPixmap(getPlayStatePixmap(), rect.size()));
     }
 
-    QPen p(QColor(Qt::white));
-    painter->setPen(p);
-    painter->drawText(QPointF(p_rect.x(), p_rect.y() - 3), name_);
+    paintName(painter);
 
     /*
     int y= 0;
@@ -77,30 +78,35 @@ void PlaylistPlayerTile::paint(QPainter *painter, const QStyleOptionGraphicsItem
 
 void PlaylistPlayerTile::receiveExternalData(const QMimeData *data)
 {
-    // extract DB::TableRecord from mime data
-    QList<DB::TableRecord*> records = Misc::JsonMimeDataParser::toTableRecordList(data);
+    // sound files dragged within this program, no parsing required
+    QList<int> ids = Misc::SoundFileMimeData::toIds(data);
+    if(!ids.isEmpty()) {
+        QElapsedTimer timer;
+        timer.start();
+
+        addMedia(ids);
+
+        qDebug() << "NOTIFICATION: Dropped" << ids.size() << "sound files on tile" << getName();
+        qDebug() << " > drop:" << timer.nsecsElapsed() / 1e6 << "ms";
+        return;
+    }
+
+    // extract sound files from mime data
+    QVector<DB::SoundFileRecord> records = Misc::JsonMimeDataParser::toSoundFileRecords(data);
 
     // validate parsing
     if(records.size() == 0)
         return;
 
-    // add media for each sound file record
-    foreach(DB::TableRecord* rec, records) {
-        if(rec->index != DB::SOUND_FILE)
-            continue;
-        addMedia(*((DB::SoundFileRecord*) rec));
-    }
-
-    // delete temp records
-    while(records.size() > 0) {
-        delete records[0];
-        records.pop_front();
-    }
+    // add media of all sound files at once
+    foreach(DB::SoundFileRecord const& rec, records)
+        ids.append(rec.id);
+    addMedia(ids);
 }
 
 void PlaylistPlayerTile::receiveWheelEvent(QWheelEvent *event)
 {
-     Playlist::Playlist* pl = player_->getCustomPlaylist();
+     Playlist::Playlist* pl = playlist_;
      Playlist::Settings* settings = pl->getSettings();
      int volume = settings->volume;
      if (event->delta() < 0){
@@ -121,6 +127,34 @@ void PlaylistPlayerTile::receiveWheelEvent(QWheelEvent *event)
      }
 }
 
+void PlaylistPlayerTile::preload()
+{
+    for(int i = 0; i < playlist_->mediaCount(); ++i)
+        Audio::PcmCache::instance()->preload(playlist_->getLocalFile(i));
+}
+
+CustomMediaPlayer *PlaylistPlayerTile::getPlayer()
+{
+    if(player_ == 0) {
+        player_ = new CustomMediaPlayer(this);
+
+        connect(this, SIGNAL(wheelChangedVolume(int)),
+                player_, SLOT(mediaVolumeChanged(int)) );
+
+        connect(player_, SIGNAL(toggledPlayerActivation(bool)),
+                this, SLOT(changedCustomPlayerActivation(bool)) );
+
+        player_->setPlaylist(playlist_);
+    }
+
+    return player_;
+}
+
+bool PlaylistPlayerTile::isInstant() const
+{
+    return instant_;
+}
+
 bool PlaylistPlayerTile::addMedia(int record_id)
 {
     if(model_ == 0)
@@ -137,6 +171,22 @@ bool PlaylistPlayerTile::addMedia(const DB::SoundFileRecord &r)
     return playlist_->addMedia(r);
 }
 
+bool PlaylistPlayerTile::addMedia(const QList<int> &record_ids)
+{
+    if(model_ == 0)
+        return false;
+
+    QList<DB::SoundFileRecord*> records;
+    records.reserve(record_ids.size());
+    foreach(int id, record_ids) {
+        DB::SoundFileRecord* rec = model_->getSoundFileById(id);
+        if(rec != 0)
+            records.append(rec);
+    }
+
+    return playlist_->addMedia(records);
+}
+
 void PlaylistPlayerTile::setSoundFileModel(DB::Model::SoundFileTableModel *m)
 {
     model_ = m;
@@ -163,6 +213,9 @@ const QJsonObject PlaylistPlayerTile::toJsonObject() const
     obj_settings = Misc::JsonMimeDataParser::toJsonObject(playlist_->getSettings());
     obj["settings"] = obj_settings;
 
+    if(instant_)
+        obj["instant"] = true;
+
     return obj;
 }
 
@@ -171,64 +224,63 @@ bool PlaylistPlayerTile::setFromJsonObject(const QJsonObject &obj)
     if(!Tile::setFromJsonObject(obj))
         return false;
 
+    // uuid is restored from project, so random draws are reproducible
+    playlist_->setRandomStream(getUuid().toString());
+
     // parse playlist
     if(obj.contains("playlist") && obj["playlist"].isArray()) {
+        // records of model, added at once after all are resolved
+        QList<DB::SoundFileRecord*> sound_files;
+
+        // parsed values, reused for each sound file
+        DB::SoundFileRecord sf_rec;
+
         foreach(QJsonValue val, obj["playlist"].toArray()) {
             QJsonObject sound_obj = val.toObject();
             if(sound_obj.isEmpty())
                 continue;
 
-            DB::TableRecord* rec = Misc::JsonMimeDataParser::toTableRecord(sound_obj);
-            if(rec->index != DB::SOUND_FILE) {
-                delete rec;
+            if(!Misc::JsonMimeDataParser::toSoundFileRecord(sound_obj, &sf_rec))
                 continue;
-            }
 
             // check existance against actual database
-            DB::SoundFileRecord* sf_rec = (DB::SoundFileRecord*) rec;
-            QList<DB::SoundFileRecord*> actual_recs = model_->getSoundFilesByRelativePath(sf_rec->relative_path);
+            QList<DB::SoundFileRecord*> actual_recs = model_->getSoundFilesByRelativePath(sf_rec.relative_path);
+            DB::SoundFileRecord* actual_rec = 0;
             if(actual_recs.size() == 0) {
                 qDebug() << "FAILURE: Could not verify SoundFile existance.";
                 qDebug() << " > SoundFile:" << sound_obj << "does not exist in any ResourceDirectory.";
-                qDebug() << " > Make sure relative path (" << sf_rec->relative_path << ") exists within a ResourceDirectory.";
-                sf_rec = 0;
-                delete rec;
+                qDebug() << " > Make sure relative path (" << sf_rec.relative_path << ") exists within a ResourceDirectory.";
                 return false;
             }
             else if(actual_recs.size() > 1) {
-                bool found = false;
                 foreach(DB::SoundFileRecord* act_rec, actual_recs) {
-                    if(act_rec->id == sf_rec->id) {
-                        sf_rec->copyFrom(act_rec);
-                        found = true;
+                    if(act_rec->id == sf_rec.id) {
+                        actual_rec = act_rec;
                         break;
                     }
                 }
 
-                if(!found) {
+                if(actual_rec == 0) {
                     qDebug() << "NOTIFICATION: More than one SoundFile exists for relative path";
                     qDebug() << " > And ID of SoundFiles parsed from JSON cannot be found in database.";
                     qDebug() << " > automatically picking first matched SoundFile.";
-                    sf_rec->copyFrom(actual_recs[0]);
+                    actual_rec = actual_recs[0];
                 }
 
 
             }
             else { // exactly one SoundFIle matches
-                sf_rec->copyFrom(actual_recs[0]);
+                actual_rec = actual_recs[0];
             }
 
-            bool success = playlist_->addMedia(*sf_rec);
-            if(!success) {
-                qDebug() << "FAILURE: Could not add SoundFile from JSON";
-                qDebug() << " > " << sound_obj;
-                sf_rec = 0;
-                delete rec;
-                return false;
-            }
+            sound_files.append(actual_rec);
+        }
 
-            sf_rec = 0;
-            delete rec;
+        bool success = playlist_->addMedia(sound_files);
+        if(!success) {
+            qDebug() << "FAILURE: Could not add SoundFiles from JSON";
+            qDebug() << " > " << obj["playlist"];
+            return false;
         }
     }
 
@@ -248,30 +300,37 @@ bool PlaylistPlayerTile::setFromJsonObject(const QJsonObject &obj)
         delete settings;
     }
 
+    // instant flag (optional)
+    if(obj.contains("instant") && obj["instant"].isBool())
+        setInstant(obj["instant"].toBool());
+
     return true;
 }
 
 
 void PlaylistPlayerTile::setMedia(const QMediaContent &c)
 {
-    player_->setMedia(c);
+    // replaces contents of playlist, like QMediaPlayer::setMedia did
+    playlist_->clear();
+    static_cast<QMediaPlaylist*>(playlist_)->addMedia(c);
 }
 
 void PlaylistPlayerTile::play()
 {
-    if(!player_->media().isNull() && !is_playing_) {
-        player_->activate();
+    if(playlist_->mediaCount() > 0 && !is_playing_) {
+        emit aboutToPlay();
+        getPlayer()->activate();
         player_->play();
-        is_playing_ = true;
+        setPlaying(true);
     }
 }
 
 void PlaylistPlayerTile::stop()
 {
-    if(!player_->media().isNull() && is_playing_) {
+    if(is_playing_) {
         player_->stop();
         player_->deactivate();
-        is_playing_ = false;
+        setPlaying(false);
     }
 }
 
@@ -285,21 +344,32 @@ void PlaylistPlayerTile::onActivate()
     Tile::onActivate();
 }
 
+void PlaylistPlayerTile::setInstant(bool instant)
+{
+    if(instant_ == instant)
+        return;
+
+    instant_ = instant;
+    if(instant_action_)
+        instant_action_->setChecked(instant_);
+    onPlaylistChanged();
+}
+
 void PlaylistPlayerTile::changePlayerState(QMediaPlayer::State state)
 {
     if (state == QMediaPlayer::PlayingState){
-        is_playing_ = true;
+        setPlaying(true);
     } else if (state == QMediaPlayer::StoppedState){
-        is_playing_ = false;
+        setPlaying(false);
     }
 }
 
 void PlaylistPlayerTile::changedCustomPlayerActivation(bool state)
 {
     if (state == true){
-        is_playing_ = true;
+        setPlaying(true);
     } else if (state == false){
-        is_playing_ = false;
+        setPlaying(false);
     }
 }
 
@@ -319,8 +389,9 @@ void PlaylistPlayerTile::onConfigurePlaylist()
     connect(playlist_settings_widget_, SIGNAL( saved(Settings*) ),
             this, SLOT(savePlaylistSettings(Settings*) ));
 
-    connect(playlist_settings_widget_, SIGNAL(volumeSettingsChanged(int)),
-            player_, SLOT(mediaVolumeChanged(int)) );
+    if(player_)
+        connect(playlist_settings_widget_, SIGNAL(volumeSettingsChanged(int)),
+                player_, SLOT(mediaVolumeChanged(int)) );
 }
 
 void PlaylistPlayerTile::onContents()
@@ -333,6 +404,29 @@ void PlaylistPlayerTile::onContents()
     }
 }
 
+void PlaylistPlayerTile::onPlaylistChanged()
+{
+    Audio::PcmCache* cache = Audio::PcmCache::instance();
+
+    QStringList paths;
+    if(instant_) {
+        for(int i = 0; i < playlist_->mediaCount(); ++i)
+            paths.append(playlist_->getLocalFile(i));
+    }
+
+    // pin first, so files staying pinned are not evicted in between
+    foreach(QString const& path, paths)
+        cache->pin(path);
+    foreach(QString const& path, pinned_paths_)
+        cache->unpin(path);
+    pinned_paths_ = paths;
+
+    if(hasActivateKey())
+        preload();
+
+    emit changed();
+}
+
 void PlaylistPlayerTile::mouseReleaseEvent(QGraphicsSceneMouseEvent *e)
 {
     if(mode_ != MOVE && e->button() == Qt::LeftButton) {
@@ -349,8 +443,9 @@ void PlaylistPlayerTile::closePlaylistSettings()
 {
     playlist_settings_widget_->hide();
 
-    disconnect(playlist_settings_widget_,SIGNAL(volumeSettingsChanged(int)),
-               player_,SLOT(mediaVolumeChanged(int)) );
+    if(player_)
+        disconnect(playlist_settings_widget_,SIGNAL(volumeSettingsChanged(int)),
+                   player_,SLOT(mediaVolumeChanged(int)) );
 
     disconnect(playlist_settings_widget_, SIGNAL(closed() ),
             this, SLOT(closePlaylistSettings() ));
@@ -368,8 +463,9 @@ void PlaylistPlayerTile::savePlaylistSettings(Settings* settings)
     playlist_->setSettings(settings);
     playlist_settings_widget_->hide();
 
-    disconnect(playlist_settings_widget_,SIGNAL(volumeSettingsChanged(int)),
-               player_,SLOT(mediaVolumeChanged(int)) );
+    if(player_)
+        disconnect(playlist_settings_widget_,SIGNAL(volumeSettingsChanged(int)),
+                   player_,SLOT(mediaVolumeChanged(int)) );
 
     disconnect(playlist_settings_widget_, SIGNAL(closed() ),
             this, SLOT(closePlaylistSettings() ));
@@ -392,19 +488,37 @@ void PlaylistPlayerTile::createContextMenu()
     connect(contents_action, SIGNAL(triggered()),
             this, SLOT(onContents()));
 
+    // keeps sound files decoded in memory
+    instant_action_ = new QAction(tr("Instant Playback"), this);
+    instant_action_->setCheckable(true);
+    instant_action_->setChecked(instant_);
+
+    connect(instant_action_, SIGNAL(toggled(bool)),
+            this, SLOT(setInstant(bool)));
+
     context_menu_->addAction(configure_action);
     context_menu_->addAction(contents_action);
+    context_menu_->addAction(instant_action_);
     context_menu_->addSeparator();
 
     Tile::createContextMenu();
 }
 
-const QPixmap PlaylistPlayerTile::getPlayStatePixmap() const
+const QPixmap* PlaylistPlayerTile::getPlayStatePixmap() const
 {
     if(is_playing_)
-        return *Resources::PX_STOP;
+        return Resources::PX_STOP;
     else
-        return *Resources::PX_PLAY;
+        return Resources::PX_PLAY;
+}
+
+void PlaylistPlayerTile::setPlaying(bool playing)
+{
+    if(is_playing_ == playing)
+        return;
+
+    is_playing_ = playing;
+    update(getPaintRect());
 }
 
 } // namespace TwoD
@@ -35,9 +35,25 @@ public:
     */
     virtual void receiveWheelEvent(QWheelEvent *event);
 
+    /**
+     * Decodes all sound files of the playlist into the audio cache.
+    */
+    virtual void preload();
+
+    /**
+     * True if tile keeps its sound files decoded (see setInstant()).
+    */
+    bool isInstant() const;
+
     bool addMedia(const DB::SoundFileRecord& r);
     bool addMedia(int record_id);
 
+    /**
+     * Adds sound files of given record ids to the playlist in one batch.
+     * Ids without record in the model are skipped.
+    */
+    bool addMedia(QList<int> const& record_ids);
+
     void setSoundFileModel(DB::Model::SoundFileTableModel* m);
     DB::Model::SoundFileTableModel* getSoundFileModel();
 
@@ -61,6 +77,12 @@ public slots:
     virtual void stop();
     virtual void onActivate();
 
+    /**
+     * Instant tiles keep their sound files decoded in the audio cache,
+     * protected from eviction (see Audio::PcmCache::pin).
+    */
+    void setInstant(bool instant);
+
     /** adjust playing icon when the player stops playing */
     void changePlayerState(QMediaPlayer::State state);
 
@@ -77,6 +99,9 @@ protected slots:
     /** slot to open contents view */
     virtual void onContents();
 
+    /** pins and preloads sound files after playlist changed */
+    void onPlaylistChanged();
+
 protected:
     /**
      * BC overrides
@@ -91,7 +116,18 @@ protected:
     /**
      * Returns the image based on the playback state
     */
-    virtual const QPixmap getPlayStatePixmap() const;
+    virtual const QPixmap* getPlayStatePixmap() const;
+
+    /**
+     * Returns player, creates it on first call.
+     * Tiles, which are never activated, do not construct a player.
+    */
+    CustomMediaPlayer* getPlayer();
+
+    /**
+     * Sets playback state, repaints play state image only.
+    */
+    void setPlaying(bool playing);
 
     CustomMediaPlayer* player_;
 
@@ -100,6 +136,10 @@ protected:
     DB::Model::SoundFileTableModel* model_;
 
     bool is_playing_;
+    bool instant_;
+    QAction* instant_action_;
+    // files pinned in audio cache
+    QStringList pinned_paths_;
 };
 
 } // namespace TwoD
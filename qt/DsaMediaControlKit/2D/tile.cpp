@@ -4,10 +4,15 @@
 #include <QMimeData>
 #include <QGraphicsScene>
 #include <QPropertyAnimation>
+#include <QParallelAnimationGroup>
 #include <QGraphicsPixmapItem>
+#include <QPixmapCache>
 #include <QMenu>
 #include <QJsonArray>
+#include <QHash>
+#include <QFontMetricsF>
 
+#include "tile_grid.h"
 #include "resources/resources.h"
 #include "misc/char_input_dialog.h"
 
@@ -26,6 +31,8 @@ Tile::Tile(QGraphicsItem* parent)
     , context_menu_(0)
     , activate_action_(0)
     , activate_key_(' ')
+    , uuid_(QUuid::createUuid())
+    , grid_(0)
 {    
     long_click_timer_ = new QTimer(this);
     connect(long_click_timer_, SIGNAL(timeout()),
@@ -34,6 +41,9 @@ Tile::Tile(QGraphicsItem* parent)
     setAcceptHoverEvents(true);
     setAcceptDrops(true);
 
+    // repaint from cached image, unless tile is changed
+    setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+
     context_menu_ = new QMenu;
 
     activate_action_ = new QAction("Activate", this);
@@ -44,6 +54,8 @@ Tile::Tile(QGraphicsItem* parent)
 
 Tile::~Tile()
 {
+    if(grid_)
+        grid_->remove(this);
     context_menu_->deleteLater();
 }
 
@@ -59,28 +71,34 @@ QRectF Tile::boundingRect() const
 
 void Tile::paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *)
 {
-    scene()->update(scene()->sceneRect());
-
-    painter->setRenderHint(QPainter::SmoothPixmapTransform);
-
-    setDefaultOpacity();
-
     QRectF p_rect(getPaintRect());
 
     painter->fillRect(p_rect, getBackgroundBrush());
     if(p_rect.width() > 0 && p_rect.height() > 0) {
+        QRect rect = p_rect.toRect();
         painter->setOpacity(0.6);
-        painter->drawPixmap((int) p_rect.x(), (int)p_rect.y(), (int) p_rect.width(), (int) p_rect.height(), getOverlayPixmap());
+        painter->drawPixmap(rect.topLeft(), getScaledPixmap(getOverlayPixmap(), rect.size()));
         painter->setOpacity(1.0);
-        QPixmap act_px = getActivatePixmap();
-        if(!act_px.isNull())
-            painter->drawPixmap((int) p_rect.x()+5, (int) p_rect.y()+5, (int) p_rect.width() / 4, (int) p_rect.height() / 4, act_px);
+        const QPixmap* act_px = getActivatePixmap();
+        if(act_px)
+            painter->drawPixmap(rect.x()+5, rect.y()+5, getScaledPixmap(act_px, rect.size() / 4));
     }
 }
 
 void Tile::setActivateKey(const QChar &c)
 {
+    if(activate_key_ == c)
+        return;
+
+    QChar previous = activate_key_;
     activate_key_ = c;
+    emit activateKeyChanged(previous);
+    update();
+    emit changed();
+
+    // key bound tiles are expected to respond instantly
+    if(hasActivateKey())
+        preload();
 }
 
 const QChar &Tile::getActivateKey() const
@@ -90,7 +108,11 @@ const QChar &Tile::getActivateKey() const
 
 void Tile::setSize(qreal size)
 {
+    prepareGeometryChange();
     size_ = size;
+    if(grid_)
+        grid_->update(this);
+    emit changed();
 }
 
 qreal Tile::getSize() const
@@ -115,15 +137,18 @@ void Tile::setSizeAnimated(qreal size)
 void Tile::setSizeLayoutAware(qreal size)
 {
     qreal prev_size = size_;
+    prepareGeometryChange();
     size_ = size;
+    if(grid_)
+        grid_->update(this);
     fixOverlapsAfterResize(prev_size);
-
-    scene()->update(scene()->sceneRect());
 }
 
 void Tile::setName(const QString &str)
 {
     name_ = str;
+    update();
+    emit changed();
 }
 
 const QString &Tile::getName() const
@@ -131,6 +156,11 @@ const QString &Tile::getName() const
     return name_;
 }
 
+const QUuid &Tile::getUuid() const
+{
+    return uuid_;
+}
+
 const QMenu *Tile::getContextMenu() const
 {
     return context_menu_;
@@ -141,6 +171,26 @@ bool Tile::hasActivateKey() const
     return activate_key_ != ' ';
 }
 
+void Tile::setTileGrid(TileGrid *grid)
+{
+    if(grid_ == grid)
+        return;
+
+    if(grid_)
+        grid_->remove(this);
+    grid_ = grid;
+    if(grid_) {
+        // position changes are needed for index updates
+        setFlag(QGraphicsItem::ItemSendsGeometryChanges, true);
+        grid_->insert(this);
+    }
+}
+
+TileGrid *Tile::getTileGrid() const
+{
+    return grid_;
+}
+
 void Tile::receiveExternalData(const QMimeData *data)
 {
     qDebug() << "Tile " << name_ <<" : Received Data "<< data->text();
@@ -152,6 +202,10 @@ void Tile::receiveWheelEvent(QWheelEvent *event)
     qDebug() << "receiving wheel event";
 }
 
+void Tile::preload()
+{
+}
+
 const QJsonObject Tile::toJsonObject() const
 {
     QJsonObject obj;
@@ -162,6 +216,7 @@ const QJsonObject Tile::toJsonObject() const
     arr_pos.append(pos().x());
     arr_pos.append(pos().y());
     obj["position"] = arr_pos;
+    obj["uuid"] = uuid_.toString();
     if(hasActivateKey())
         obj["activate_key"] = QString(activate_key_);
 
@@ -188,6 +243,13 @@ bool Tile::setFromJsonObject(const QJsonObject &obj)
     setSize((qreal) obj["size"].toDouble());
     setPos(QPointF(arr_pos[0].toDouble(), arr_pos[1].toDouble()));
 
+    // set uuid (missing in older projects)
+    if(obj.contains("uuid") && obj["uuid"].isString()) {
+        QUuid uuid(obj["uuid"].toString());
+        if(!uuid.isNull())
+            uuid_ = uuid;
+    }
+
     // set activate key
     if(obj.contains("activate_key") && obj["activate_key"].isString()) {
         QString k = obj["activate_key"].toString();
@@ -235,7 +297,7 @@ void Tile::mouseMoveEvent(QGraphicsSceneMouseEvent* e)
         QGraphicsItem::mouseMoveEvent(e);
         QPointF p_new = pos();
 
-        QList<QGraphicsItem*> col_it = collidingItems(Qt::IntersectsItemBoundingRect);
+        QList<Tile*> col_it = collidingTiles();
         if(col_it.size() > 0) {
             qreal x_min = col_it[0]->pos().x() - boundingRect().width();
             qreal x_max = col_it[0]->pos().x() + col_it[0]->boundingRect().width();
@@ -275,8 +337,7 @@ void Tile::mouseMoveEvent(QGraphicsSceneMouseEvent* e)
             setPos(x(), max_y);
 
         // if still colliding set pos back to start
-        col_it = collidingItems(Qt::IntersectsItemBoundingRect);
-        if(col_it.size() > 0)
+        if(collidingTiles().size() > 0)
             setPos(p);
     }
 
@@ -319,103 +380,114 @@ void Tile::contextMenuEvent(QGraphicsSceneContextMenuEvent *e)
     context_menu_->popup(e->screenPos());
 }
 
+QVariant Tile::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    if(change == ItemPositionHasChanged)
+        emit changed();
+
+    if(grid_) {
+        if(change == ItemPositionHasChanged)
+            grid_->update(this);
+        else if(change == ItemSceneHasChanged && scene() == 0)
+            setTileGrid(0);
+    }
+
+    return QGraphicsItem::itemChange(change, value);
+}
+
+const QList<Tile*> Tile::collidingTiles() const
+{
+    if(grid_)
+        return grid_->tilesIn(sceneBoundingRect(), this);
+
+    QList<Tile*> tiles;
+    foreach(QGraphicsItem* it, collidingItems(Qt::IntersectsItemBoundingRect)) {
+        Tile* t = dynamic_cast<Tile*>(it);
+        if(t)
+            tiles.append(t);
+    }
+    return tiles;
+}
+
 void Tile::fixOverlapsAfterResize(qreal prev_size)
 {
     if(prev_size >= size_)
         return;
 
-    QList<QGraphicsItem*> cols = collidingItems(Qt::IntersectsItemShape);
     // no collision, keep layout
-    if(cols.size() == 0)
+    if(collidingTiles().size() == 0)
         return;
 
-    // all movement animations will have to be perfromed
-    // after seting the psoitions statically for quick intersect computation
-    QMap<QGraphicsItem*,QPropertyAnimation*> animations;
-
-    // fix overlapping
-    qreal dist = abs(size_ * 100 - prev_size * 100);
-    bool collision = true;
-    QSet<QGraphicsItem*> items = scene()->items().toSet();
-    items.remove(this);
-    while(collision) {
-        collision = false;
-        QSet<QGraphicsItem*> remove_items;
-        foreach(QGraphicsItem* it, items) {
-            // cast necessary for property animation
-            Tile* c_it = dynamic_cast<Tile*>(it);
-
-            // skip non GraphicsItems
-            if(!c_it)
-                continue;
+    QRectF fixed = sceneBoundingRect();
 
-            /*if(c_it->x() < x()-c_it->boundingRect().width() || c_it->y() < y()-c_it->boundingRect().height()) {
-                remove_items.insert(it);
-                continue;
-            }*/
+    // start positions of moved tiles, for animation after final positions are set
+    QHash<Tile*, QPointF> start_pos;
+    QRectF moved_bounds;
 
-            // do not move non colliding
-            if(c_it->collidingItems(Qt::IntersectsItemShape).size() == 0)
+    // constraint push: each pushed tile pushes the tiles it overlaps in turn.
+    // Tiles only move right or down, so the chain ends at the border of the layout.
+    QList<Tile*> pushers;
+    pushers.append(this);
+    while(!pushers.isEmpty()) {
+        Tile* pusher = pushers.takeFirst();
+        QRectF p_rect = pusher->sceneBoundingRect();
+
+        foreach(Tile* t, pusher->collidingTiles()) {
+            if(t == this)
                 continue;
 
-            // move item along extension of sized item
-            QPointF start = c_it->pos();
-            QPointF end(c_it->pos().x()+dist, c_it->pos().y()+dist);
-
-            // start and end might be same for started animations
-            //if((start - end).manhattanLength() < 0.0001)
-            //    continue;
-
-            // actual new collsion found
-            collision = true;
-
-            if(!animations.contains(it)) {
-                // store positional change animation
-                QPropertyAnimation* anim = new QPropertyAnimation(c_it, "pos");
-                anim->setDuration(300);
-                anim->setStartValue(start);
-                anim->setEndValue(end);
-                anim->setEasingCurve(QEasingCurve::InOutQuad);
-                animations[it] = anim;
-            }
+            // minimal displacement resolving the overlap with pusher
+            QRectF t_rect = t->sceneBoundingRect();
+            QPointF offset = minimalPush(t_rect, p_rect);
 
-            // set final pos statically for now
-            // overlap computation will be easier that way
-            // after all final positions are reached
-            // position change will be animated again
-            c_it->setPos(end);
-
-            // add to list of moved items
-            // (use 'it' since 'c_it' is casted)
-            remove_items.insert(it);
-
-            // extend scene bounds if item gets pushed out of screen
-            // x
-            qreal max_x = scene()->width() - c_it->boundingRect().width();
-            if (end.x() > max_x) {
-                qreal screen_ext = max_x - end.x();
-                QRectF rect = scene()->sceneRect();
-                rect.setWidth(rect.width() + abs(screen_ext));
-                scene()->setSceneRect(rect);
-            }
-            // y
-            qreal max_y = scene()->height() - c_it->boundingRect().height();
-            if (end.y() > max_y) {
-                qreal screen_ext = max_y - end.y();
-                QRectF rect = scene()->sceneRect();
-                rect.setHeight(rect.height() + abs(screen_ext));
-                scene()->setSceneRect(rect);
+            // resized tile stays in place, push further if it would be hit
+            if(t_rect.translated(offset).intersects(fixed)) {
+                if(offset.x() > 0)
+                    offset.setX(fixed.right() - t_rect.left());
+                else
+                    offset.setY(fixed.bottom() - t_rect.top());
             }
+
+            if(!start_pos.contains(t))
+                start_pos.insert(t, t->pos());
+
+            // final pos is set statically, so following collision checks use it
+            t->setPos(t->pos() + offset);
+            moved_bounds |= t->sceneBoundingRect();
+            pushers.append(t);
         }
+    }
 
-        // limit items to the ones, which have not been moved
-        items.subtract(remove_items);
+    // extend scene bounds once, so pushed tiles stay reachable
+    QRectF scene_rect = scene()->sceneRect();
+    if(moved_bounds.right() > scene_rect.right())
+        scene_rect.setRight(moved_bounds.right());
+    if(moved_bounds.bottom() > scene_rect.bottom())
+        scene_rect.setBottom(moved_bounds.bottom());
+    scene()->setSceneRect(scene_rect);
+
+    // animate all moves from start to final position together
+    QParallelAnimationGroup* group = new QParallelAnimationGroup;
+    QHash<Tile*, QPointF>::const_iterator it = start_pos.constBegin();
+    for(; it != start_pos.constEnd(); ++it) {
+        QPropertyAnimation* anim = new QPropertyAnimation(it.key(), "pos");
+        anim->setDuration(300);
+        anim->setStartValue(it.value());
+        anim->setEndValue(it.key()->pos());
+        anim->setEasingCurve(QEasingCurve::InOutQuad);
+        group->addAnimation(anim);
     }
+    group->start(QAbstractAnimation::DeleteWhenStopped);
+}
 
-    // trigger transitions
-    foreach(QPropertyAnimation* anim, animations.values())
-        anim->start(QAbstractAnimation::DeleteWhenStopped);
+const QPointF Tile::minimalPush(const QRectF &rect, const QRectF &pusher)
+{
+    qreal dx = pusher.right() - rect.left();
+    qreal dy = pusher.bottom() - rect.top();
 
+    if(dx <= dy)
+        return QPointF(dx, 0);
+    return QPointF(0, dy);
 }
 
 const QRectF Tile::getPaintRect() const
@@ -444,20 +516,47 @@ const QBrush Tile::getBackgroundBrush() const
     return b;
 }
 
-const QPixmap Tile::getOverlayPixmap() const
+const QPixmap* Tile::getOverlayPixmap() const
 {
     if(mode_ == SELECTED)
-        return *Resources::PX_CRACKED_STONE_INV;
+        return Resources::PX_CRACKED_STONE_INV;
     else
-        return *Resources::PX_CRACKED_STONE;
+        return Resources::PX_CRACKED_STONE;
+}
+
+const QPixmap* Tile::getActivatePixmap() const
+{
+    return Resources::getKeyPixmap(activate_key_);
 }
 
-const QPixmap Tile::getActivatePixmap() const
+const QPixmap Tile::getScaledPixmap(const QPixmap *px, const QSize &size)
 {
-    QPixmap* px = Resources::getKeyPixmap(activate_key_);
-    if(px == 0)
+    if(px == 0 || px->isNull() || size.isEmpty())
         return QPixmap();
-    return *px;
+
+    QString key = QString("tile_%1_%2x%3").arg(px->cacheKey()).arg(size.width()).arg(size.height());
+    QPixmap scaled;
+    if(!QPixmapCache::find(key, &scaled)) {
+        scaled = px->scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        QPixmapCache::insert(key, scaled);
+    }
+    return scaled;
+}
+
+void Tile::paintName(QPainter *painter) const
+{
+    QRectF p_rect(getPaintRect());
+    QFontMetricsF metrics(painter->font());
+    QRectF label_rect(p_rect.x(), p_rect.bottom() - metrics.height() - 2, p_rect.width(), metrics.height() + 2);
+    if(name_.isEmpty() || label_rect.top() < p_rect.top())
+        return;
+
+    painter->fillRect(label_rect, QColor(0, 0, 0, 128));
+    QPen p(QColor(Qt::white));
+    painter->setPen(p);
+    QRectF text_rect = label_rect.adjusted(3, 0, -3, 0);
+    painter->drawText(text_rect, Qt::AlignLeft | Qt::AlignVCenter,
+                      metrics.elidedText(name_, Qt::ElideRight, text_rect.width()));
 }
 
 void Tile::setDefaultOpacity()
@@ -477,6 +576,7 @@ void Tile::setDefaultOpacity()
 void Tile::setMode(Tile::ItemMode mode)
 {
     mode_ = mode;
+    setDefaultOpacity();
     update(boundingRect());
 }
 
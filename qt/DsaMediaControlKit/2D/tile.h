@@ -14,11 +14,14 @@
 #include <QMediaPlayer>
 #include <QShortcut>
 #include <QJsonObject>
+#include <QUuid>
 
 #include "db/handler.h"
 
 namespace TwoD {
 
+class TileGrid;
+
 /**
  * Square 2D tile.
  * Supports hover, onlick and drag handling.
@@ -117,6 +120,11 @@ public:
     */
     const QString& getName() const;
 
+    /**
+     * Get unique id of tile, stable across save and load.
+    */
+    const QUuid& getUuid() const;
+
     /**
      * Get context menu of tile.
     */
@@ -127,6 +135,17 @@ public:
     */
     bool hasActivateKey() const;
 
+    /**
+     * Sets spatial index the tile keeps its scene rect updated in.
+     * Removes tile from previous index. Tile leaves index when removed from scene.
+    */
+    void setTileGrid(TileGrid* grid);
+
+    /**
+     * Returns spatial index of tile, 0 if not set.
+    */
+    TileGrid* getTileGrid() const;
+
     /**
      * Hand mime data such as drop data to tile.
      * This class only prints the mime text.
@@ -139,6 +158,12 @@ public:
     */
     virtual void receiveWheelEvent(QWheelEvent *event);
 
+    /**
+     * Prepares tile, so activation responds without delay.
+     * Called for tiles with activate key. This class does nothing.
+    */
+    virtual void preload();
+
     /**
      * Returns a QJsonObject holding all information about the tile
     */
@@ -158,6 +183,15 @@ signals:
     void hoverLeft(QGraphicsSceneHoverEvent *e);
     void activated();
 
+    /** key for quick activate has been changed, previous key is given */
+    void activateKeyChanged(QChar previous);
+
+    /** emitted by playing tiles right before playback gets started */
+    void aboutToPlay();
+
+    /** state saved by toJsonObject() has changed (position, size, name, key, ...) */
+    void changed();
+
 public slots:
     /** interface for tile interaction */
     virtual void onActivate();
@@ -194,12 +228,26 @@ protected:
     virtual void dragEnterEvent(QGraphicsSceneDragDropEvent *event);
     virtual void dragMoveEvent(QGraphicsSceneDragDropEvent *event);
     virtual void dropEvent(QGraphicsSceneDragDropEvent *event);
+    virtual QVariant itemChange(GraphicsItemChange change, const QVariant& value);
 
     /**
-    * relayouts all other tiles based on overlaps created by resize operation
+    * Returns tiles intersecting bounding rect of this tile.
+    * Uses spatial index if set, otherwise collidingItems() of the scene.
+    */
+    const QList<Tile*> collidingTiles() const;
+
+    /**
+    * Relayouts all other tiles based on overlaps created by resize operation.
+    * Overlapped tiles get pushed right or down, whichever moves them less,
+    * and push the tiles they overlap in turn. Moves are animated as one group.
     */
     virtual void fixOverlapsAfterResize(qreal prev_size);
 
+    /**
+    * Returns smallest offset to the right or down, moving rect off pusher.
+    */
+    static const QPointF minimalPush(const QRectF& rect, const QRectF& pusher);
+
     /**
     * Returns QRectF definition for draw area.
     */
@@ -213,12 +261,25 @@ protected:
     /**
     * Returns tile background overlay pixmap.
     */
-    const QPixmap getOverlayPixmap() const;
+    const QPixmap* getOverlayPixmap() const;
+
+    /**
+    * Returns activate shortcut pixamp, 0 if there is none.
+    */
+    const QPixmap* getActivatePixmap() const;
+
+    /**
+    * Returns pixmap smoothly scaled to size.
+    * Scaled pixmaps are kept in QPixmapCache, so each size is scaled once
+    * and shared by all tiles.
+    */
+    static const QPixmap getScaledPixmap(const QPixmap* px, const QSize& size);
 
     /**
-    * Returns activate shortcut pixamp.
+    * Paints name on a strip along the bottom of the paint rect, elided to fit.
+    * The name stays within boundingRect(), the item cache clips anything outside.
     */
-    const QPixmap getActivatePixmap() const;
+    void paintName(QPainter* painter) const;
 
     /**
     * Sets default opacity value based on ItemState.
@@ -253,6 +314,8 @@ protected:
     QMenu* context_menu_;
     QAction* activate_action_;
     QChar activate_key_;
+    QUuid uuid_;
+    TileGrid* grid_;
 };
 
 } // namespace TwoD
@@ -0,0 +1,165 @@
+#include "tile_grid.h"
+
+#include <cmath>
+
+#include "tile.h"
+
+namespace TwoD {
+
+TileGrid::TileGrid(qreal cell_size)
+    : cell_size_(cell_size)
+    , cells_()
+    , rects_()
+{}
+
+void TileGrid::insert(Tile *tile)
+{
+    if(rects_.contains(tile))
+        return;
+
+    QRectF rect = tile->sceneBoundingRect();
+    rects_.insert(tile, rect);
+    insertCells(tile, cellRange(rect));
+}
+
+void TileGrid::remove(Tile *tile)
+{
+    QHash<Tile*, QRectF>::iterator it = rects_.find(tile);
+    if(it == rects_.end())
+        return;
+
+    removeCells(tile, cellRange(it.value()));
+    rects_.erase(it);
+}
+
+void TileGrid::update(Tile *tile)
+{
+    QHash<Tile*, QRectF>::iterator it = rects_.find(tile);
+    if(it == rects_.end())
+        return;
+
+    QRectF rect = tile->sceneBoundingRect();
+    if(rect == it.value())
+        return;
+
+    // cells only change when tile crosses cell borders
+    QRect prev_range = cellRange(it.value());
+    QRect range = cellRange(rect);
+    it.value() = rect;
+    if(prev_range != range) {
+        removeCells(tile, prev_range);
+        insertCells(tile, range);
+    }
+}
+
+bool TileGrid::contains(Tile *tile) const
+{
+    return rects_.contains(tile);
+}
+
+const QRectF TileGrid::getRect(Tile *tile) const
+{
+    return rects_.value(tile);
+}
+
+Tile *TileGrid::tileAt(const QPointF &p) const
+{
+    int x = (int) std::floor(p.x() / cell_size_);
+    int y = (int) std::floor(p.y() / cell_size_);
+
+    QHash<quint64, QVector<Tile*> >::const_iterator cell = cells_.constFind(cellKey(x, y));
+    if(cell == cells_.constEnd())
+        return 0;
+
+    foreach(Tile* t, cell.value()) {
+        if(rects_.value(t).contains(p))
+            return t;
+    }
+    return 0;
+}
+
+const QList<Tile*> TileGrid::tilesIn(const QRectF &rect, const Tile *ignore) const
+{
+    QList<Tile*> tiles;
+    QRect range = cellRange(rect);
+
+    for(int x = range.left(); x <= range.right(); ++x) {
+        for(int y = range.top(); y <= range.bottom(); ++y) {
+            QHash<quint64, QVector<Tile*> >::const_iterator cell = cells_.constFind(cellKey(x, y));
+            if(cell == cells_.constEnd())
+                continue;
+
+            foreach(Tile* t, cell.value()) {
+                // tiles spanning several cells are listed in each of them
+                if(t != ignore && !tiles.contains(t) && rects_.value(t).intersects(rect))
+                    tiles.append(t);
+            }
+        }
+    }
+
+    return tiles;
+}
+
+bool TileGrid::intersects(const QRectF &rect, const Tile *ignore) const
+{
+    QRect range = cellRange(rect);
+
+    for(int x = range.left(); x <= range.right(); ++x) {
+        for(int y = range.top(); y <= range.bottom(); ++y) {
+            QHash<quint64, QVector<Tile*> >::const_iterator cell = cells_.constFind(cellKey(x, y));
+            if(cell == cells_.constEnd())
+                continue;
+
+            foreach(Tile* t, cell.value()) {
+                if(t != ignore && rects_.value(t).intersects(rect))
+                    return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+const QList<Tile*> TileGrid::getTiles() const
+{
+    return rects_.keys();
+}
+
+const QRect TileGrid::cellRange(const QRectF &rect) const
+{
+    int left = (int) std::floor(rect.left() / cell_size_);
+    int top = (int) std::floor(rect.top() / cell_size_);
+    int right = (int) std::floor(rect.right() / cell_size_);
+    int bottom = (int) std::floor(rect.bottom() / cell_size_);
+    return QRect(QPoint(left, top), QPoint(right, bottom));
+}
+
+quint64 TileGrid::cellKey(int x, int y)
+{
+    return ((quint64) (quint32) x << 32) | (quint32) y;
+}
+
+void TileGrid::insertCells(Tile *tile, const QRect &range)
+{
+    for(int x = range.left(); x <= range.right(); ++x) {
+        for(int y = range.top(); y <= range.bottom(); ++y)
+            cells_[cellKey(x, y)].append(tile);
+    }
+}
+
+void TileGrid::removeCells(Tile *tile, const QRect &range)
+{
+    for(int x = range.left(); x <= range.right(); ++x) {
+        for(int y = range.top(); y <= range.bottom(); ++y) {
+            QHash<quint64, QVector<Tile*> >::iterator cell = cells_.find(cellKey(x, y));
+            if(cell == cells_.end())
+                continue;
+
+            cell.value().removeOne(tile);
+            if(cell.value().isEmpty())
+                cells_.erase(cell);
+        }
+    }
+}
+
+} // namespace TwoD
@@ -0,0 +1,88 @@
+#ifndef TWO_D_TILE_GRID_H
+#define TWO_D_TILE_GRID_H
+
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QRect>
+#include <QRectF>
+#include <QPointF>
+
+namespace TwoD {
+
+class Tile;
+
+/**
+ * Spatial index over the scene rectangles of tiles.
+ * The scene is divided into square cells, each cell lists the tiles
+ * overlapping it. Point and rectangle queries only visit the cells
+ * covered by the query, so their cost does not grow with the number of tiles.
+ * Tiles update their entry when moved or resized (see Tile::setTileGrid).
+*/
+class TileGrid
+{
+public:
+    TileGrid(qreal cell_size = 100);
+
+    /**
+     * Adds tile with its current scene bounding rect.
+    */
+    void insert(Tile* tile);
+
+    /**
+     * Removes tile, does nothing if tile is not contained.
+    */
+    void remove(Tile* tile);
+
+    /**
+     * Updates entry of tile to its current scene bounding rect.
+    */
+    void update(Tile* tile);
+
+    bool contains(Tile* tile) const;
+
+    /**
+     * Returns indexed rect of tile (empty rect if not contained).
+    */
+    const QRectF getRect(Tile* tile) const;
+
+    /**
+     * Returns a tile containing given scene point, 0 if there is none.
+    */
+    Tile* tileAt(const QPointF& p) const;
+
+    /**
+     * Returns all tiles intersecting given scene rect, except ignore.
+     * Touching edges do not count as intersection.
+    */
+    const QList<Tile*> tilesIn(const QRectF& rect, const Tile* ignore = 0) const;
+
+    /**
+     * Returns true if any tile except ignore intersects given scene rect.
+    */
+    bool intersects(const QRectF& rect, const Tile* ignore = 0) const;
+
+    /**
+     * Returns all indexed tiles.
+    */
+    const QList<Tile*> getTiles() const;
+
+private:
+    /**
+     * Range of cells covered by rect.
+    */
+    const QRect cellRange(const QRectF& rect) const;
+
+    static quint64 cellKey(int x, int y);
+
+    void insertCells(Tile* tile, const QRect& range);
+    void removeCells(Tile* tile, const QRect& range);
+
+    qreal cell_size_;
+    QHash<quint64, QVector<Tile*> > cells_;
+    QHash<Tile*, QRectF> rects_;
+};
+
+} // namespace TwoD
+
+#endif // TWO_D_TILE_GRID_H
@@ -21,6 +21,16 @@ SOURCES += main.cpp \
     _TEST/content_browser.cpp \
     _TEST/multi_track_media_player.cpp \
     _TEST/player_controls.cpp \
+    _TEST/mixer_benchmark.cpp \
+    _TEST/layout_benchmark.cpp \
+    _TEST/render_benchmark.cpp \
+    _TEST/project_format_benchmark.cpp \
+    _TEST/record_parser_benchmark.cpp \
+    _TEST/benchmark_database.cpp \
+    _TEST/lookup_benchmark.cpp \
+    _TEST/category_query_benchmark.cpp \
+    _TEST/schema_check.cpp \
+    _TEST/scheduler_check.cpp \
     db/core/api.cpp \
     db/core/sqlite_wrapper.cpp \
     db/model/category_tree_model.cpp \
@@ -33,20 +43,32 @@ SOURCES += main.cpp \
     resources/resources.cpp \
     misc/drop_group_box.cpp \
     misc/json_mime_data_parser.cpp \
+    misc/sound_file_mime_data.cpp \
     misc/standard_item_model.cpp \
     misc/char_input_dialog.cpp \
+    misc/random_service.cpp \
+    misc/project_file.cpp \
+    misc/autosave.cpp \
     sound_file/resource_importer.cpp \
+    sound_file/import_worker.cpp \
     sound_file/list_view.cpp \
     sound_file/path_fixer.cpp \
     sound_file/master_view.cpp \
     sound_file/list_view_dialog.cpp \
     2D/graphics_view.cpp \
     2D/tile.cpp \
+    2D/tile_grid.cpp \
     2D/player_tile.cpp \
     2D/playlist_player_tile.cpp \
     playlist/playlist.cpp \
     playlist/settings_widget.cpp \
+    playlist/weighted_scheduler.cpp \
     custom_media_player.cpp \
+    audio/pcm_stream.cpp \
+    audio/playback_engine.cpp \
+    audio/mixer.cpp \
+    audio/pcm_cache.cpp \
+    audio/mix_kernels.cpp \
     db/model/resource_dir_table_model.cpp
 
 HEADERS  += main_window.h \
@@ -54,6 +76,16 @@ HEADERS  += main_window.h \
     _TEST/content_browser.h \
     _TEST/multi_track_media_player.h \
     _TEST/player_controls.h \
+    _TEST/mixer_benchmark.h \
+    _TEST/layout_benchmark.h \
+    _TEST/render_benchmark.h \
+    _TEST/project_format_benchmark.h \
+    _TEST/record_parser_benchmark.h \
+    _TEST/benchmark_database.h \
+    _TEST/lookup_benchmark.h \
+    _TEST/category_query_benchmark.h \
+    _TEST/schema_check.h \
+    _TEST/scheduler_check.h \
     db/core/api.h \
     db/core/sqlite_wrapper.h \
     db/model/category_tree_model.h \
@@ -66,21 +98,36 @@ HEADERS  += main_window.h \
     resources/resources.h \
     misc/drop_group_box.h \
     misc/char_input_dialog.h \
+    misc/random_service.h \
+    misc/project_file.h \
+    misc/autosave.h \
     misc/json_mime_data_parser.h \
+    misc/sound_file_mime_data.h \
     misc/standard_item_model.h \
+    misc/bounded_queue.h \
     sound_file/resource_importer.h \
+    sound_file/import_worker.h \
     sound_file/list_view.h \
     sound_file/path_fixer.h \
     sound_file/master_view.h \
     sound_file/list_view_dialog.h \
     2D/graphics_view.h \
     2D/tile.h \
+    2D/tile_grid.h \
     2D/player_tile.h \
     2D/playlist_player_tile.h \
     playlist/playlist.h \
     playlist/settings.h \
     playlist/settings_widget.h \
+    playlist/weighted_scheduler.h \
     custom_media_player.h \
+    audio/pcm_stream.h \
+    audio/playback_engine.h \
+    audio/audio_format.h \
+    audio/voice.h \
+    audio/mixer.h \
+    audio/pcm_cache.h \
+    audio/mix_kernels.h \
     db/model/resource_dir_table_model.h
 
 RESOURCES += \
@@ -0,0 +1,76 @@
+#include "benchmark_database.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include "resources/resources.h"
+
+// root of the generated sound files (never accessed on disk)
+#define BENCHMARK_RESOURCE_DIR "/benchmark/sounds"
+
+namespace _TEST {
+
+BenchmarkDatabase::BenchmarkDatabase()
+    : dir_()
+    , api_(0)
+    , sound_file_count_(0)
+{
+    QString db_path = QDir(dir_.path()).filePath("benchmark.db");
+    if(!dir_.isValid() || !QFile::copy(Resources::DATABASE_PATH, db_path)) {
+        qDebug() << "FAILURE: Could not create benchmark database";
+        qDebug() << " > Copy of:" << Resources::DATABASE_PATH;
+        return;
+    }
+
+    api_ = new DB::Core::Api(db_path);
+    api_->deleteAll();
+}
+
+BenchmarkDatabase::~BenchmarkDatabase()
+{
+    delete api_;
+}
+
+bool BenchmarkDatabase::isValid() const
+{
+    return api_ != 0;
+}
+
+DB::Core::Api *BenchmarkDatabase::getApi()
+{
+    return api_;
+}
+
+QList<int> BenchmarkDatabase::addSoundFiles(int count)
+{
+    QList<int> ids;
+    if(api_ == 0)
+        return ids;
+
+    DB::ResourceDirRecord resource_dir(-1, "sounds", BENCHMARK_RESOURCE_DIR);
+
+    api_->beginTransaction();
+    for(int i = 0; i < count; ++i) {
+        int id = api_->insertSoundFile(QFileInfo(getSoundFilePath(sound_file_count_)), resource_dir);
+        if(id != -1)
+            ids.append(id);
+        ++sound_file_count_;
+    }
+    api_->commitTransaction();
+
+    return ids;
+}
+
+QString BenchmarkDatabase::getSoundFilePath(int i)
+{
+    return BENCHMARK_RESOURCE_DIR + getSoundFileRelativePath(i);
+}
+
+QString BenchmarkDatabase::getSoundFileRelativePath(int i)
+{
+    return "/folder_" + QString::number(i / 100) + "/sound_" + QString::number(i) + ".ogg";
+}
+
+} // namespace _TEST
@@ -0,0 +1,49 @@
+#ifndef TEST_BENCHMARK_DATABASE_H
+#define TEST_BENCHMARK_DATABASE_H
+
+#include <QList>
+#include <QTemporaryDir>
+
+#include "db/core/api.h"
+
+namespace _TEST {
+
+/*
+ * Empty copy of the application database (Resources::DATABASE_PATH)
+ * in a temporary directory, with all schema migrations applied.
+ * Used by benchmarks and checks on the db, removed on destruction.
+ * Opens the default db connection, so only one may exist at a time.
+ **/
+class BenchmarkDatabase
+{
+public:
+    BenchmarkDatabase();
+    ~BenchmarkDatabase();
+
+    /* Returns false if copy of the database could not be created */
+    bool isValid() const;
+
+    DB::Core::Api* getApi();
+
+    /*
+     * Inserts count sound files (within one transaction),
+     * spread over sub folders of 100 files each.
+     * Returns ids of the inserted sound files.
+    */
+    QList<int> addSoundFiles(int count);
+
+    /* Returns path of sound file number i (see addSoundFiles(...)) */
+    static QString getSoundFilePath(int i);
+
+    /* Returns relative path of sound file number i */
+    static QString getSoundFileRelativePath(int i);
+
+private:
+    QTemporaryDir dir_;
+    DB::Core::Api* api_;
+    int sound_file_count_;
+};
+
+} // namespace _TEST
+
+#endif // TEST_BENCHMARK_DATABASE_H
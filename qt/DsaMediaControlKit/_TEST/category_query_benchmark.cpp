@@ -0,0 +1,117 @@
+#include "category_query_benchmark.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QSqlRecord>
+
+#include "_TEST/benchmark_database.h"
+#include "db/model/sound_file_table_model.h"
+
+// levels below the root category
+#define BENCHMARK_TREE_DEPTH 6
+// subcategories per category
+#define BENCHMARK_TREE_FANOUT 4
+// sound files spread over all categories
+#define BENCHMARK_SOUND_FILES 20000
+// runs measured per subtree and query path
+#define BENCHMARK_RUNS 10
+
+namespace _TEST {
+
+/*
+ * Returns given category id and all ids of its descendants.
+ **/
+static QList<int> subtreeIds(QMap<int, QList<int> > const& children, int category_id)
+{
+    QList<int> ids;
+    ids.append(category_id);
+    for(int i = 0; i < ids.size(); ++i)
+        ids.append(children.value(ids[i]));
+    return ids;
+}
+
+/*
+ * Former query path, one SELECT per category of the subtree
+ * and one model lookup per sound file.
+ **/
+static QList<DB::SoundFileRecord*> perCategoryQuery(DB::Core::Api* api, DB::Model::SoundFileTableModel* model, QList<int> const& cat_ids)
+{
+    QList<DB::SoundFileRecord*> records;
+    foreach(int c_id, cat_ids) {
+        foreach(int s_id, api->getRelatedIds(DB::SOUND_FILE, DB::CATEGORY, c_id))
+            records.append(model->getSoundFileById(s_id));
+    }
+    return records;
+}
+
+void CategoryQueryBenchmark::run()
+{
+    BenchmarkDatabase db;
+    if(!db.isValid())
+        return;
+    DB::Core::Api* api = db.getApi();
+
+    // category tree, breadth first, level by level
+    QMap<int, QList<int> > children;
+    QList<QList<int> > levels;
+    api->beginTransaction();
+    levels.append(QList<int>() << api->insertCategory("root"));
+    for(int depth = 1; depth <= BENCHMARK_TREE_DEPTH; ++depth) {
+        QList<int> level;
+        foreach(int parent_id, levels.last()) {
+            for(int i = 0; i < BENCHMARK_TREE_FANOUT; ++i) {
+                int id = api->insertCategory("category_" + QString::number(depth) + "_" + QString::number(level.size()), parent_id);
+                children[parent_id].append(id);
+                level.append(id);
+            }
+        }
+        levels.append(level);
+    }
+    api->commitTransaction();
+
+    QList<int> cat_ids = subtreeIds(children, levels[0][0]);
+    QList<int> sound_file_ids = db.addSoundFiles(BENCHMARK_SOUND_FILES);
+    api->beginTransaction();
+    for(int i = 0; i < sound_file_ids.size(); ++i)
+        api->insertSoundFileCategory(sound_file_ids[i], cat_ids[(i * 7) % cat_ids.size()]);
+    api->commitTransaction();
+
+    DB::Model::SoundFileTableModel model(api);
+    model.select();
+
+    qDebug() << "Category query benchmark," << cat_ids.size() << "categories,"
+             << sound_file_ids.size() << "sound files," << BENCHMARK_RUNS << "runs per query";
+
+    // subtrees from the root down to the parents of the leaves
+    for(int depth = 0; depth < BENCHMARK_TREE_DEPTH; ++depth) {
+        int category_id = levels[depth][0];
+        QList<int> subtree = subtreeIds(children, category_id);
+
+        QElapsedTimer timer;
+        QList<DB::SoundFileRecord*> recursive;
+        timer.start();
+        for(int i = 0; i < BENCHMARK_RUNS; ++i)
+            recursive = model.getSoundFilesByDbRecords(api->getSoundFilesByCategorySubtree(category_id));
+        qint64 recursive_ns = timer.nsecsElapsed();
+
+        QList<DB::SoundFileRecord*> per_category;
+        timer.restart();
+        for(int i = 0; i < BENCHMARK_RUNS; ++i)
+            per_category = perCategoryQuery(api, &model, subtree);
+        qint64 per_category_ns = timer.nsecsElapsed();
+
+        bool equal = recursive.toSet() == per_category.toSet();
+
+        qDebug() << " > level" << depth << "|" << subtree.size() << "categories |"
+                 << recursive.size() << "sound files | same result:" << equal;
+        qDebug() << "    recursive query:   " << QString::number(recursive_ns / (1e6 * BENCHMARK_RUNS), 'f', 2) << "ms"
+                 << "| 1 query";
+        qDebug() << "    query per category:" << QString::number(per_category_ns / (1e6 * BENCHMARK_RUNS), 'f', 2) << "ms"
+                 << "|" << subtree.size() << "queries";
+    }
+}
+
+} // namespace _TEST
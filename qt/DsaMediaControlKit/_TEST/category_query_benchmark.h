@@ -0,0 +1,22 @@
+#ifndef TEST_CATEGORY_QUERY_BENCHMARK_H
+#define TEST_CATEGORY_QUERY_BENCHMARK_H
+
+namespace _TEST {
+
+/*
+ * Measures resolving the sound files of a category subtree
+ * on a deep category tree (7 levels, 5461 categories, 20k sound files),
+ * with the recursive query (Api::getSoundFilesByCategorySubtree)
+ * and with one getRelatedIds query per category of the subtree.
+ * Started with command line option --category-benchmark,
+ * results are written to the debug output.
+ **/
+class CategoryQueryBenchmark
+{
+public:
+    static void run();
+};
+
+} // namespace _TEST
+
+#endif // TEST_CATEGORY_QUERY_BENCHMARK_H
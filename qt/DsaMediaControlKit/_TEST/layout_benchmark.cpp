@@ -0,0 +1,82 @@
+#include "layout_benchmark.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QGraphicsScene>
+#include <QList>
+#include <QPointF>
+#include <QtMath>
+
+#include "2D/tile.h"
+#include "2D/tile_grid.h"
+
+// resizes measured per board and size
+#define BENCHMARK_RUNS 10
+
+namespace _TEST {
+
+/*
+ * Fills scene with square board of small tiles, registered in grid.
+ **/
+static QList<TwoD::Tile*> createBoard(QGraphicsScene* scene, TwoD::TileGrid* grid, int count)
+{
+    int side = (int) qCeil(qSqrt(count));
+    scene->setSceneRect(0, 0, side * 100, side * 100);
+
+    QList<TwoD::Tile*> tiles;
+    for(int i = 0; i < count; ++i) {
+        TwoD::Tile* tile = new TwoD::Tile;
+        tile->setPos((i % side) * 100, (i / side) * 100);
+        scene->addItem(tile);
+        tile->setTileGrid(grid);
+        tiles.append(tile);
+    }
+    return tiles;
+}
+
+void LayoutBenchmark::run()
+{
+    qDebug() << "Layout benchmark, resizing upper left tile of dense boards";
+    qDebug() << " >" << BENCHMARK_RUNS << "runs per board and size";
+
+    for(int count = 100; count <= 1000; count *= 2) {
+        for(int size = 2; size <= 3; ++size) {
+            qint64 total_ns = 0;
+            qint64 max_ns = 0;
+            int moved = 0;
+
+            for(int run = 0; run < BENCHMARK_RUNS; ++run) {
+                // grid outlives scene, which deletes the tiles
+                TwoD::TileGrid grid;
+                QGraphicsScene scene;
+                QList<TwoD::Tile*> tiles = createBoard(&scene, &grid, count);
+
+                QList<QPointF> start;
+                foreach(TwoD::Tile* t, tiles)
+                    start.append(t->pos());
+
+                QElapsedTimer timer;
+                timer.start();
+                tiles[0]->setSizeLayoutAware(size);
+                qint64 ns = timer.nsecsElapsed();
+
+                total_ns += ns;
+                max_ns = qMax(max_ns, ns);
+
+                moved = 0;
+                for(int i = 0; i < tiles.size(); ++i) {
+                    if(tiles[i]->pos() != start[i])
+                        ++moved;
+                }
+            }
+
+            qDebug() << " > tiles:" << count
+                     << "| size:" << size
+                     << "| moved:" << moved
+                     << "| mean:" << QString::number(total_ns / (1e6 * BENCHMARK_RUNS), 'f', 3) << "ms"
+                     << "| max:" << QString::number(max_ns / 1e6, 'f', 3) << "ms";
+        }
+    }
+}
+
+} // namespace _TEST
@@ -0,0 +1,21 @@
+#ifndef TEST_LAYOUT_BENCHMARK_H
+#define TEST_LAYOUT_BENCHMARK_H
+
+namespace _TEST {
+
+/*
+ * Measures overlap resolution of tiles on dense boards (100 to 800 tiles).
+ * Tiles are packed without gaps, a tile in the upper left corner grows,
+ * so the push cascades through the board.
+ * Started with command line option --layout-benchmark,
+ * results are written to the debug output.
+ **/
+class LayoutBenchmark
+{
+public:
+    static void run();
+};
+
+} // namespace _TEST
+
+#endif // TEST_LAYOUT_BENCHMARK_H
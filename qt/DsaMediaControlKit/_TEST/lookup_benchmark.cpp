@@ -0,0 +1,131 @@
+#include "lookup_benchmark.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QList>
+
+#include "_TEST/benchmark_database.h"
+#include "db/model/sound_file_table_model.h"
+
+// lookups measured per method and library size
+#define BENCHMARK_LOOKUPS 1000
+
+namespace _TEST {
+
+/*
+ * Writes average duration of a single lookup.
+ **/
+static void report(QString const& name, qint64 ns)
+{
+    double us = ns / (1e3 * BENCHMARK_LOOKUPS);
+    qDebug() << "   " << name << QString::number(us, 'f', 3) << "us/lookup";
+}
+
+/*
+ * Returns record with given id by scanning all records.
+ **/
+static DB::SoundFileRecord* scanById(QList<DB::SoundFileRecord*> const& records, int id)
+{
+    foreach(DB::SoundFileRecord* rec, records) {
+        if(rec->id == id)
+            return rec;
+    }
+    return 0;
+}
+
+/*
+ * Returns record with given path by scanning all records.
+ **/
+static DB::SoundFileRecord* scanByPath(QList<DB::SoundFileRecord*> const& records, QString const& path)
+{
+    foreach(DB::SoundFileRecord* rec, records) {
+        if(rec->path == path)
+            return rec;
+    }
+    return 0;
+}
+
+/*
+ * Measures all lookups for a library of given size.
+ **/
+static void runSize(int size)
+{
+    BenchmarkDatabase db;
+    if(!db.isValid())
+        return;
+
+    QList<int> ids = db.addSoundFiles(size);
+
+    DB::Model::SoundFileTableModel model(db.getApi());
+    model.select();
+    QList<DB::SoundFileRecord*> const& records = model.getSoundFiles();
+
+    qDebug() << "Lookup benchmark," << records.size() << "sound files,"
+             << BENCHMARK_LOOKUPS << "lookups per method";
+    if(records.size() != size || ids.size() != size) {
+        qDebug() << "FAILURE: Could not create sound files";
+        return;
+    }
+
+    // lookup keys spread over the whole library
+    int step = size / BENCHMARK_LOOKUPS > 0 ? size / BENCHMARK_LOOKUPS : 1;
+    QList<int> keys;
+    for(int i = 0; i < BENCHMARK_LOOKUPS; ++i)
+        keys.append((i * step + step / 2) % size);
+
+    QElapsedTimer timer;
+    int found = 0;
+
+    timer.start();
+    foreach(int i, keys)
+        found += model.getSoundFileById(ids[i]) != 0;
+    qint64 id_ns = timer.nsecsElapsed();
+
+    timer.restart();
+    foreach(int i, keys)
+        found += scanById(records, ids[i]) != 0;
+    qint64 scan_id_ns = timer.nsecsElapsed();
+
+    timer.restart();
+    foreach(int i, keys)
+        found += model.getSoundFileByPath(BenchmarkDatabase::getSoundFilePath(i)) != 0;
+    qint64 path_ns = timer.nsecsElapsed();
+
+    timer.restart();
+    foreach(int i, keys)
+        found += scanByPath(records, BenchmarkDatabase::getSoundFilePath(i)) != 0;
+    qint64 scan_path_ns = timer.nsecsElapsed();
+
+    timer.restart();
+    foreach(int i, keys)
+        found += model.getSoundFilesByRelativePath(BenchmarkDatabase::getSoundFileRelativePath(i)).size();
+    qint64 rel_path_ns = timer.nsecsElapsed();
+
+    timer.restart();
+    foreach(int i, keys)
+        found += model.getRowBySoundFile(records[i]) != -1;
+    qint64 row_ns = timer.nsecsElapsed();
+
+    timer.restart();
+    foreach(int i, keys)
+        found += records.indexOf(records[i]) != -1;
+    qint64 scan_row_ns = timer.nsecsElapsed();
+
+    qDebug() << " > sound files found:" << found << "of" << 7 * BENCHMARK_LOOKUPS;
+    report("by id:               ", id_ns);
+    report("by id (scan):        ", scan_id_ns);
+    report("by path:             ", path_ns);
+    report("by path (scan):      ", scan_path_ns);
+    report("by relative path:    ", rel_path_ns);
+    report("row of record:       ", row_ns);
+    report("row of record (scan):", scan_row_ns);
+}
+
+void LookupBenchmark::run()
+{
+    runSize(1000);
+    runSize(10000);
+    runSize(100000);
+}
+
+} // namespace _TEST
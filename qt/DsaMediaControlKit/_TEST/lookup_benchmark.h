@@ -0,0 +1,21 @@
+#ifndef TEST_LOOKUP_BENCHMARK_H
+#define TEST_LOOKUP_BENCHMARK_H
+
+namespace _TEST {
+
+/*
+ * Measures sound file lookups of SoundFileTableModel (by id, path,
+ * relative path and row) against a linear scan of the record list,
+ * for libraries of 1k, 10k and 100k sound files.
+ * Started with command line option --lookup-benchmark,
+ * results are written to the debug output.
+ **/
+class LookupBenchmark
+{
+public:
+    static void run();
+};
+
+} // namespace _TEST
+
+#endif // TEST_LOOKUP_BENCHMARK_H
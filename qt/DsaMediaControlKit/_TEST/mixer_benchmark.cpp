@@ -0,0 +1,94 @@
+#include "mixer_benchmark.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QList>
+#include <QtMath>
+#include <cstring>
+
+#include "audio/audio_format.h"
+#include "audio/mixer.h"
+#include "audio/mix_kernels.h"
+
+// frames mixed per block, similar to a pull of the audio output
+#define BENCHMARK_BLOCK_FRAMES 512
+// seconds of audio mixed per voice count
+#define BENCHMARK_SECONDS 60
+
+namespace _TEST {
+
+/*
+ * Voice looping one second of a sine tone.
+ **/
+class ToneVoice : public Audio::Voice
+{
+public:
+    ToneVoice(double frequency)
+        : table_(AUDIO_SAMPLE_RATE * AUDIO_CHANNELS)
+        , pos_(0)
+    {
+        for(int i = 0; i < AUDIO_SAMPLE_RATE; ++i) {
+            float val = (float) qSin(2 * M_PI * frequency * i / AUDIO_SAMPLE_RATE);
+            for(int c = 0; c < AUDIO_CHANNELS; ++c)
+                table_[i * AUDIO_CHANNELS + c] = val;
+        }
+    }
+
+    virtual void render(float* out, int frames)
+    {
+        while(frames > 0) {
+            int n = qMin(frames, AUDIO_SAMPLE_RATE - pos_);
+            std::memcpy(out, table_.constData() + pos_ * AUDIO_CHANNELS,
+                        n * AUDIO_CHANNELS * sizeof(float));
+            out += n * AUDIO_CHANNELS;
+            frames -= n;
+            pos_ = (pos_ + n) % AUDIO_SAMPLE_RATE;
+        }
+    }
+
+private:
+    QVector<float> table_;
+    int pos_;
+};
+
+void MixerBenchmark::run()
+{
+    qDebug() << "Mixer benchmark, SIMD kernels:" << Audio::hasSimdKernels();
+    qDebug() << " > mixing" << BENCHMARK_SECONDS << "s of audio per voice count,"
+             << BENCHMARK_BLOCK_FRAMES << "frames per block";
+
+    QVector<float> out(BENCHMARK_BLOCK_FRAMES * AUDIO_CHANNELS);
+    QVector<qint16> converted(BENCHMARK_BLOCK_FRAMES * AUDIO_CHANNELS);
+    int blocks = BENCHMARK_SECONDS * AUDIO_SAMPLE_RATE / BENCHMARK_BLOCK_FRAMES;
+
+    for(int count = 1; count <= 64; count *= 2) {
+        Audio::Mixer mixer;
+        QList<ToneVoice*> voices;
+        for(int i = 0; i < count; ++i) {
+            ToneVoice* voice = new ToneVoice(110.0 * (i + 1));
+            voice->setGain(1.0f / count);
+            voices.append(voice);
+            mixer.addVoice(voice);
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        for(int b = 0; b < blocks; ++b) {
+            mixer.mix(out.data(), BENCHMARK_BLOCK_FRAMES);
+            Audio::convertFrames(converted.data(), out.constData(), BENCHMARK_BLOCK_FRAMES);
+        }
+        qint64 ns = timer.nsecsElapsed();
+
+        // share of one core needed to mix in real time
+        double load = ns / (BENCHMARK_SECONDS * 1e9) * 100.0;
+        qDebug() << " > voices:" << count
+                 << "| CPU:" << QString::number(load, 'f', 4) << "%"
+                 << "| CPU per voice:" << QString::number(load / count, 'f', 4) << "%"
+                 << "| ns per voice and block:" << ns / blocks / count;
+
+        qDeleteAll(voices);
+    }
+}
+
+} // namespace _TEST
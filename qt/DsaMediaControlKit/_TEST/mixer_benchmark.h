@@ -0,0 +1,20 @@
+#ifndef TEST_MIXER_BENCHMARK_H
+#define TEST_MIXER_BENCHMARK_H
+
+namespace _TEST {
+
+/*
+ * Measures CPU time of the mixer per active voice (1 to 64 voices).
+ * Voices play a precomputed tone, so decoding is not part of the measurement.
+ * Started with command line option --mixer-benchmark,
+ * results are written to the debug output.
+ **/
+class MixerBenchmark
+{
+public:
+    static void run();
+};
+
+} // namespace _TEST
+
+#endif // TEST_MIXER_BENCHMARK_H
@@ -0,0 +1,74 @@
+#include "project_format_benchmark.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QBuffer>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "misc/project_file.h"
+
+// loads measured per file and format
+#define BENCHMARK_RUNS 200
+
+namespace _TEST {
+
+void ProjectFormatBenchmark::run(const QStringList &paths)
+{
+    qDebug() << "Project format benchmark," << BENCHMARK_RUNS << "loads per file and format";
+
+    foreach(QString const& path, paths) {
+        QFile file(path);
+        if(!file.open(QFile::ReadOnly)) {
+            qDebug() << " > could not open" << path;
+            continue;
+        }
+        QByteArray json = file.readAll();
+
+        QJsonObject obj = QJsonDocument::fromJson(json).object();
+        if(obj.isEmpty()) {
+            qDebug() << " > no JSON project:" << path;
+            continue;
+        }
+
+        QByteArray binary;
+        QBuffer out(&binary);
+        out.open(QBuffer::WriteOnly);
+        Misc::ProjectFile::writeBinary(&out, obj);
+        out.close();
+
+        // JSON -> binary -> JSON
+        QBuffer in(&binary);
+        in.open(QBuffer::ReadOnly);
+        QJsonObject restored;
+        bool lossless = Misc::ProjectFile::readBinary(&in, &restored) && restored == obj;
+        in.close();
+
+        QElapsedTimer timer;
+        timer.start();
+        for(int i = 0; i < BENCHMARK_RUNS; ++i)
+            QJsonDocument::fromJson(json).object();
+        qint64 json_ns = timer.nsecsElapsed();
+
+        timer.restart();
+        for(int i = 0; i < BENCHMARK_RUNS; ++i) {
+            QBuffer buffer(&binary);
+            buffer.open(QBuffer::ReadOnly);
+            QJsonObject o;
+            Misc::ProjectFile::readBinary(&buffer, &o);
+        }
+        qint64 binary_ns = timer.nsecsElapsed();
+
+        qDebug() << " >" << QFileInfo(path).fileName()
+                 << "| lossless:" << lossless;
+        qDebug() << "   size JSON:" << json.size() << "bytes"
+                 << "| compact JSON:" << QJsonDocument(obj).toJson(QJsonDocument::Compact).size() << "bytes"
+                 << "| binary:" << binary.size() << "bytes";
+        qDebug() << "   load JSON:" << QString::number(json_ns / (1e3 * BENCHMARK_RUNS), 'f', 1) << "us"
+                 << "| binary:" << QString::number(binary_ns / (1e3 * BENCHMARK_RUNS), 'f', 1) << "us";
+    }
+}
+
+} // namespace _TEST
@@ -0,0 +1,22 @@
+#ifndef TEST_PROJECT_FORMAT_BENCHMARK_H
+#define TEST_PROJECT_FORMAT_BENCHMARK_H
+
+#include <QStringList>
+
+namespace _TEST {
+
+/*
+ * Compares size and load time of JSON and binary project files
+ * and checks that JSON converts to binary and back without loss.
+ * Started with command line option --project-benchmark followed by
+ * paths of JSON projects, results are written to the debug output.
+ **/
+class ProjectFormatBenchmark
+{
+public:
+    static void run(QStringList const& paths);
+};
+
+} // namespace _TEST
+
+#endif // TEST_PROJECT_FORMAT_BENCHMARK_H
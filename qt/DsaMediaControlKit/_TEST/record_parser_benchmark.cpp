@@ -0,0 +1,131 @@
+#include "record_parser_benchmark.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMimeData>
+#include <QList>
+#include <QVector>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "misc/json_mime_data_parser.h"
+
+// sound file records converted per run
+#define BENCHMARK_RECORDS 100000
+// runs measured per conversion
+#define BENCHMARK_RUNS 5
+
+namespace _TEST {
+
+/*
+ * Writes duration and throughput of a conversion.
+ **/
+static void report(QString const& name, qint64 ns)
+{
+    double ms = ns / (1e6 * BENCHMARK_RUNS);
+    qDebug() << "   " << name << QString::number(ms, 'f', 1) << "ms"
+             << "|" << QString::number(BENCHMARK_RECORDS / ms, 'f', 0) << "records/ms";
+}
+
+void RecordParserBenchmark::run()
+{
+    qDebug() << "Record parser benchmark," << BENCHMARK_RECORDS << "sound files,"
+             << BENCHMARK_RUNS << "runs per conversion";
+
+    QVector<DB::SoundFileRecord> values;
+    values.reserve(BENCHMARK_RECORDS);
+    QList<DB::TableRecord*> pointers;
+    for(int i = 0; i < BENCHMARK_RECORDS; ++i) {
+        QString name = "sound_" + QString::number(i);
+        QString rel_path = "ambience/forest/" + name + ".ogg";
+        values.append(DB::SoundFileRecord(i, name, "C:/sounds/" + rel_path, rel_path));
+        pointers.append(new DB::SoundFileRecord(values.last()));
+    }
+
+    QElapsedTimer timer;
+
+    // serialize
+    timer.start();
+    for(int i = 0; i < BENCHMARK_RUNS; ++i)
+        delete Misc::JsonMimeDataParser::toJsonMimeData(pointers);
+    qint64 serialize_pointer_ns = timer.nsecsElapsed();
+
+    timer.restart();
+    for(int i = 0; i < BENCHMARK_RUNS; ++i)
+        delete Misc::JsonMimeDataParser::toJsonMimeData(values);
+    qint64 serialize_value_ns = timer.nsecsElapsed();
+
+    QMimeData* mime = Misc::JsonMimeDataParser::toJsonMimeData(values);
+
+    // parse
+    timer.restart();
+    for(int i = 0; i < BENCHMARK_RUNS; ++i) {
+        QList<DB::TableRecord*> records = Misc::JsonMimeDataParser::toTableRecordList(mime);
+        while(records.size() > 0) {
+            delete records[0];
+            records.pop_front();
+        }
+    }
+    qint64 parse_pointer_ns = timer.nsecsElapsed();
+
+    timer.restart();
+    for(int i = 0; i < BENCHMARK_RUNS; ++i)
+        Misc::JsonMimeDataParser::toSoundFileRecords(mime);
+    qint64 parse_value_ns = timer.nsecsElapsed();
+
+    // share of parsing spent extracting (and allocating) the strings:
+    // three string attributes minus one int attribute per record
+    // (so it still includes two key lookups)
+    QJsonArray arr = QJsonDocument::fromJson(mime->text().toUtf8()).array();
+    qint64 chars = 0;
+    qint64 ids = 0;
+    timer.restart();
+    for(int i = 0; i < BENCHMARK_RUNS; ++i) {
+        foreach(QJsonValue const& val, arr) {
+            QJsonObject obj = val.toObject();
+            chars += obj.value("name").toString().size();
+            chars += obj.value("path").toString().size();
+            chars += obj.value("relative_path").toString().size();
+        }
+    }
+    qint64 parse_strings_ns = timer.nsecsElapsed();
+
+    timer.restart();
+    for(int i = 0; i < BENCHMARK_RUNS; ++i) {
+        foreach(QJsonValue const& val, arr)
+            ids += val.toObject().value("id").toInt();
+    }
+    qint64 parse_lookup_ns = timer.nsecsElapsed();
+
+    // both ways restore all records
+    QVector<DB::SoundFileRecord> parsed = Misc::JsonMimeDataParser::toSoundFileRecords(mime);
+    bool equal = parsed.size() == values.size();
+    for(int i = 0; equal && i < parsed.size(); ++i) {
+        equal = parsed[i].id == values[i].id && parsed[i].name == values[i].name
+             && parsed[i].path == values[i].path && parsed[i].relative_path == values[i].relative_path;
+    }
+    QList<DB::TableRecord*> parsed_pointers = Misc::JsonMimeDataParser::toTableRecordList(mime);
+    equal = equal && parsed_pointers.size() == values.size();
+
+    qDebug() << " > records restored:" << equal;
+    report("serialize TableRecord*:", serialize_pointer_ns);
+    report("serialize by value:    ", serialize_value_ns);
+    report("parse TableRecord*:    ", parse_pointer_ns);
+    report("parse by value:        ", parse_value_ns);
+    report("  of which strings:    ", parse_strings_ns - parse_lookup_ns);
+    qDebug() << " > strings allocated per record: 3," << chars / BENCHMARK_RUNS / BENCHMARK_RECORDS
+             << "chars in total (id sum" << ids / BENCHMARK_RUNS << ")";
+
+    while(parsed_pointers.size() > 0) {
+        delete parsed_pointers[0];
+        parsed_pointers.pop_front();
+    }
+    while(pointers.size() > 0) {
+        delete pointers[0];
+        pointers.pop_front();
+    }
+    delete mime;
+}
+
+} // namespace _TEST
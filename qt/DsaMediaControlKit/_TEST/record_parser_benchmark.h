@@ -0,0 +1,22 @@
+#ifndef TEST_RECORD_PARSER_BENCHMARK_H
+#define TEST_RECORD_PARSER_BENCHMARK_H
+
+namespace _TEST {
+
+/*
+ * Measures parse and serialize throughput of JsonMimeDataParser
+ * for 100k sound file records, with heap allocated records (TableRecord*)
+ * and with records by value (QVector<SoundFileRecord>),
+ * and the share of the string attributes in parsing.
+ * Started with command line option --record-benchmark,
+ * results are written to the debug output.
+ **/
+class RecordParserBenchmark
+{
+public:
+    static void run();
+};
+
+} // namespace _TEST
+
+#endif // TEST_RECORD_PARSER_BENCHMARK_H
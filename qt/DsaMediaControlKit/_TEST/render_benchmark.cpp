@@ -0,0 +1,82 @@
+#include "render_benchmark.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QPixmap>
+#include <QList>
+#include <QtMath>
+
+#include "2D/tile.h"
+
+#define BENCHMARK_TILES 200
+#define BENCHMARK_COLUMNS 20
+// tiles are placed far enough apart to grow without overlap
+#define BENCHMARK_SPACING 160
+#define BENCHMARK_FRAMES 300
+
+namespace _TEST {
+
+/*
+ * Renders frames of view, changing tiles before each frame if animated.
+ **/
+static void measure(QGraphicsView* view, QList<TwoD::Tile*> const& tiles, bool animated)
+{
+    QPixmap frame(view->viewport()->size());
+    qint64 total_ns = 0;
+    qint64 max_ns = 0;
+
+    for(int f = 0; f < BENCHMARK_FRAMES; ++f) {
+        QElapsedTimer timer;
+        timer.start();
+
+        if(animated) {
+            // sizes between small and 1.5 times small, like a size animation
+            for(int i = 0; i < tiles.size(); ++i)
+                tiles[i]->setSize(1.25 + 0.25 * qSin(f * 0.1 + i));
+        }
+        view->viewport()->render(&frame);
+
+        qint64 ns = timer.nsecsElapsed();
+        total_ns += ns;
+        max_ns = qMax(max_ns, ns);
+    }
+
+    double mean_ms = total_ns / (1e6 * BENCHMARK_FRAMES);
+    qDebug() << " >" << (animated ? "animated:" : "idle:    ")
+             << "mean:" << QString::number(mean_ms, 'f', 3) << "ms"
+             << "| max:" << QString::number(max_ns / 1e6, 'f', 3) << "ms"
+             << "| fps:" << QString::number(1000.0 / mean_ms, 'f', 1);
+}
+
+void RenderBenchmark::run()
+{
+    qDebug() << "Render benchmark," << BENCHMARK_TILES << "tiles,"
+             << BENCHMARK_FRAMES << "frames per scenario";
+
+    int rows = (BENCHMARK_TILES + BENCHMARK_COLUMNS - 1) / BENCHMARK_COLUMNS;
+    QGraphicsScene scene(0, 0, BENCHMARK_COLUMNS * BENCHMARK_SPACING, rows * BENCHMARK_SPACING);
+
+    QString keys("ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789");
+    QList<TwoD::Tile*> tiles;
+    for(int i = 0; i < BENCHMARK_TILES; ++i) {
+        TwoD::Tile* tile = new TwoD::Tile;
+        tile->setPos((i % BENCHMARK_COLUMNS) * BENCHMARK_SPACING, (i / BENCHMARK_COLUMNS) * BENCHMARK_SPACING);
+        tile->setActivateKey(keys.at(i % keys.size()));
+        scene.addItem(tile);
+        tiles.append(tile);
+    }
+
+    QGraphicsView view(&scene);
+    view.resize(scene.sceneRect().size().toSize());
+
+    // first frame fills pixmap and item caches
+    QPixmap frame(view.viewport()->size());
+    view.viewport()->render(&frame);
+
+    measure(&view, tiles, false);
+    measure(&view, tiles, true);
+}
+
+} // namespace _TEST
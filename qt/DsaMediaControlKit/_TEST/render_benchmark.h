@@ -0,0 +1,21 @@
+#ifndef TEST_RENDER_BENCHMARK_H
+#define TEST_RENDER_BENCHMARK_H
+
+namespace _TEST {
+
+/*
+ * Measures frame time of a view showing 200 key bound tiles.
+ * Frames are rendered with unchanged tiles (cached) and with
+ * all tiles animating their size.
+ * Started with command line option --render-benchmark,
+ * results are written to the debug output.
+ **/
+class RenderBenchmark
+{
+public:
+    static void run();
+};
+
+} // namespace _TEST
+
+#endif // TEST_RENDER_BENCHMARK_H
@@ -0,0 +1,143 @@
+#include "scheduler_check.h"
+
+#include <QDebug>
+#include <QVector>
+
+#include <random>
+
+#include "playlist/weighted_scheduler.h"
+
+// draws per frequency check
+#define CHECK_DRAWS 1000000
+// seed of the random engine
+#define CHECK_SEED 42
+// copies of a shuffle bag, if weight ratios need more (see WeightedScheduler)
+#define CHECK_BAG_SIZE 1024
+
+namespace _TEST {
+
+/*
+ * Returns scheduler in given mode with given weights.
+ **/
+static Playlist::WeightedScheduler* createScheduler(QVector<double> const& weights, Playlist::WeightedScheduler::Mode mode, int no_repeat_count = 0)
+{
+    Playlist::WeightedScheduler* scheduler = new Playlist::WeightedScheduler;
+    scheduler->setMode(mode, no_repeat_count);
+    scheduler->insert(0, weights.size());
+    for(int i = 0; i < weights.size(); ++i)
+        scheduler->setWeight(i, weights[i]);
+    return scheduler;
+}
+
+/*
+ * Returns draw count per index.
+ **/
+static QVector<int> draw(Playlist::WeightedScheduler* scheduler, std::mt19937& rng, int draws)
+{
+    QVector<int> counts(scheduler->size(), 0);
+    for(int i = 0; i < draws; ++i) {
+        int index = scheduler->next(rng);
+        if(index >= 0)
+            ++counts[index];
+    }
+    return counts;
+}
+
+/*
+ * Returns chi-square statistic of counts, expected counts follow
+ * getProbability(). Indices with probability 0 must not be drawn at all.
+ * Degrees of freedom are returned in degrees.
+ **/
+static double chiSquare(Playlist::WeightedScheduler* scheduler, QVector<int> const& counts, int draws, int* degrees)
+{
+    double chi = 0;
+    *degrees = -1;
+    for(int i = 0; i < counts.size(); ++i) {
+        double expected = scheduler->getProbability(i) * draws;
+        if(expected <= 0) {
+            if(counts[i] > 0)
+                return -1;
+            continue;
+        }
+        chi += (counts[i] - expected) * (counts[i] - expected) / expected;
+        ++(*degrees);
+    }
+    return chi;
+}
+
+/*
+ * Writes result of a check and returns passed.
+ **/
+static bool report(QString const& name, bool passed, QVector<int> const& counts)
+{
+    qDebug() << (passed ? "PASS:" : "FAIL:") << name.toUtf8().constData();
+    if(!passed)
+        qDebug() << " > counts:" << counts;
+    return passed;
+}
+
+bool SchedulerCheck::run()
+{
+    qDebug() << "Scheduler check," << CHECK_DRAWS << "draws per frequency check";
+
+    std::mt19937 rng(CHECK_SEED);
+    bool passed = true;
+    int degrees = 0;
+
+    // chi-square critical values at p = 0.001, for 3 and 5 degrees of freedom
+    double const critical[] = {0, 0, 0, 16.27, 0, 20.52};
+
+    // frequencies follow weights, weight 0 is never drawn
+    {
+        Playlist::WeightedScheduler* scheduler = createScheduler(QVector<double>() << 1 << 2 << 3 << 4 << 0, Playlist::WeightedScheduler::INDEPENDENT);
+        QVector<int> counts = draw(scheduler, rng, CHECK_DRAWS);
+        double chi = chiSquare(scheduler, counts, CHECK_DRAWS, &degrees);
+        passed = report("independent draws follow weights", chi >= 0 && chi < critical[degrees], counts) && passed;
+        delete scheduler;
+    }
+
+    // no index repeats within window, equal weights stay uniform
+    {
+        int window = 3;
+        Playlist::WeightedScheduler* scheduler = createScheduler(QVector<double>(6, 1.0), Playlist::WeightedScheduler::NO_REPEAT, window);
+        QVector<int> counts(scheduler->size(), 0);
+        QVector<int> last_draw(scheduler->size(), -window - 1);
+        bool repeated = false;
+        for(int i = 0; i < CHECK_DRAWS; ++i) {
+            int index = scheduler->next(rng);
+            repeated = repeated || i - last_draw[index] <= window;
+            last_draw[index] = i;
+            ++counts[index];
+        }
+        double chi = chiSquare(scheduler, counts, CHECK_DRAWS, &degrees);
+        passed = report("no repeat window is kept", !repeated, counts) && passed;
+        passed = report("no repeat draws of equal weights are uniform", chi >= 0 && chi < critical[degrees], counts) && passed;
+        delete scheduler;
+    }
+
+    // integer ratios 2 : 6 : 1 : 4, so each bag holds 13 copies
+    {
+        Playlist::WeightedScheduler* scheduler = createScheduler(QVector<double>() << 1 << 3 << 0.5 << 2, Playlist::WeightedScheduler::SHUFFLE_BAG);
+        int bags = 1000;
+        QVector<int> counts = draw(scheduler, rng, 13 * bags);
+        bool exact = counts == (QVector<int>() << 2 * bags << 6 * bags << 1 * bags << 4 * bags);
+        passed = report("shuffle bag copies follow integer weight ratios", exact, counts) && passed;
+        delete scheduler;
+    }
+
+    // ratios need more copies than a bag holds, fractions are carried over
+    {
+        Playlist::WeightedScheduler* scheduler = createScheduler(QVector<double>() << 1 << 0.37 << 0.001, Playlist::WeightedScheduler::SHUFFLE_BAG);
+        QVector<int> counts = draw(scheduler, rng, CHECK_DRAWS);
+        bool within_bag = true;
+        for(int i = 0; i < counts.size(); ++i)
+            within_bag = within_bag && qAbs(counts[i] - scheduler->getProbability(i) * CHECK_DRAWS) <= CHECK_BAG_SIZE;
+        passed = report("shuffle bag counts stay within one bag of weights", within_bag, counts) && passed;
+        delete scheduler;
+    }
+
+    qDebug() << (passed ? " > all checks passed" : " > some checks failed");
+    return passed;
+}
+
+} // namespace _TEST
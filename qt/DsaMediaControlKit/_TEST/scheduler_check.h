@@ -0,0 +1,24 @@
+#ifndef TEST_SCHEDULER_CHECK_H
+#define TEST_SCHEDULER_CHECK_H
+
+namespace _TEST {
+
+/*
+ * Statistical checks of Playlist::WeightedScheduler:
+ * draw frequencies of INDEPENDENT and NO_REPEAT mode (chi-square test),
+ * the no repeat window, and copy counts of SHUFFLE_BAG mode
+ * for integer weight ratios (exact) and for carried fractions.
+ * Draws use a fixed seed, so results are reproducible.
+ * Started with command line option --scheduler-check,
+ * results are written to the debug output.
+ **/
+class SchedulerCheck
+{
+public:
+    /* Returns true if all checks passed */
+    static bool run();
+};
+
+} // namespace _TEST
+
+#endif // TEST_SCHEDULER_CHECK_H
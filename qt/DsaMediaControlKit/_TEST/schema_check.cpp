@@ -0,0 +1,105 @@
+#include "schema_check.h"
+
+#include <QDebug>
+#include <QRegExp>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QVariant>
+
+#include "_TEST/benchmark_database.h"
+
+namespace _TEST {
+
+/*
+ * Returns the detail lines of the query plan of given query,
+ * bound values are all set to 1.
+ **/
+static QStringList queryPlan(QString const& qry_str, int value_count)
+{
+    QStringList plan;
+
+    QSqlQuery qry;
+    qry.prepare("EXPLAIN QUERY PLAN " + qry_str);
+    for(int i = 0; i < value_count; ++i)
+        qry.addBindValue(1);
+
+    if(!qry.exec()) {
+        qDebug() << "FAILURE: could not explain query";
+        qDebug() << " > Query:" << qry_str;
+        qDebug() << " > Error:" << qry.lastError().text();
+        return plan;
+    }
+
+    while(qry.next())
+        plan.append(qry.value(3).toString());
+
+    return plan;
+}
+
+/*
+ * Checks query plan of given query, see SchemaCheck.
+ * Query strings mirror the ones built in DB::Core::Api.
+ **/
+static bool check(QString const& name, QString const& qry_str, int value_count, QString const& index)
+{
+    // old sqlite versions write 'SCAN TABLE', newer ones 'SCAN'
+    QRegExp table_scan("^SCAN (TABLE )?(sound_file|category|sound_file_category)\\b");
+
+    QStringList plan = queryPlan(qry_str, value_count);
+    bool uses_index = false;
+    bool scans_table = false;
+    foreach(QString const& line, plan) {
+        uses_index = uses_index || line.contains("INDEX " + index);
+        scans_table = scans_table || table_scan.indexIn(line) != -1;
+    }
+
+    bool passed = plan.size() > 0 && uses_index && !scans_table;
+    qDebug() << (passed ? "PASS:" : "FAIL:") << name.toUtf8().constData() << "uses" << index;
+    if(!passed) {
+        foreach(QString const& line, plan)
+            qDebug() << " >" << line;
+    }
+
+    return passed;
+}
+
+bool SchemaCheck::run()
+{
+    BenchmarkDatabase db;
+    if(!db.isValid())
+        return false;
+
+    qDebug() << "Schema check";
+
+    bool passed = true;
+
+    // Api::getSoundFileId(...)
+    passed = check("sound file id by path",
+        "SELECT id FROM sound_file WHERE path = ?",
+        1, "sqlite_autoindex_sound_file_1") && passed;
+
+    // Api::soundFileExists(...)
+    passed = check("sound file exists",
+        "SELECT Count(*) FROM sound_file WHERE path = ? and name = ?",
+        2, "sqlite_autoindex_sound_file_1") && passed;
+
+    // Api::getRelatedIds(SOUND_FILE, CATEGORY, ...)
+    passed = check("sound file ids by category",
+        "SELECT sound_file_id FROM sound_file_category WHERE category_id = ?",
+        1, "sound_file_category_category_id_idx") && passed;
+
+    // Api::getSoundFilesByCategorySubtree(...)
+    passed = check("sound files by category subtree",
+        "WITH RECURSIVE subtree(id) AS (SELECT id FROM category WHERE id = ?"
+        " UNION SELECT category.id FROM category JOIN subtree ON category.parent_id = subtree.id) "
+        "SELECT DISTINCT sound_file.id, sound_file.name, sound_file.path, sound_file.relative_path, sound_file.weight "
+        "FROM sound_file JOIN sound_file_category ON sound_file_category.sound_file_id = sound_file.id "
+        "WHERE sound_file_category.category_id IN subtree ORDER BY sound_file.id",
+        1, "category_parent_id_idx") && passed;
+
+    qDebug() << (passed ? " > all checks passed" : " > some checks failed");
+    return passed;
+}
+
+} // namespace _TEST
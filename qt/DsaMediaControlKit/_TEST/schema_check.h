@@ -0,0 +1,23 @@
+#ifndef TEST_SCHEMA_CHECK_H
+#define TEST_SCHEMA_CHECK_H
+
+namespace _TEST {
+
+/*
+ * Checks the query plans (EXPLAIN QUERY PLAN) of the hot lookups of
+ * DB::Core::Api on a migrated copy of the database.
+ * A check fails if a query scans one of the tables sound_file, category,
+ * sound_file_category or does not use the index expected for it.
+ * Started with command line option --schema-check,
+ * results are written to the debug output.
+ **/
+class SchemaCheck
+{
+public:
+    /* Returns true if all checks passed */
+    static bool run();
+};
+
+} // namespace _TEST
+
+#endif // TEST_SCHEMA_CHECK_H
@@ -0,0 +1,8 @@
+#ifndef AUDIO_AUDIO_FORMAT_H
+#define AUDIO_AUDIO_FORMAT_H
+
+// format of all PCM handled by the audio engine (interleaved float samples)
+#define AUDIO_SAMPLE_RATE 44100
+#define AUDIO_CHANNELS 2
+
+#endif // AUDIO_AUDIO_FORMAT_H
@@ -0,0 +1,116 @@
+#include "mix_kernels.h"
+
+#include <cstring>
+
+#include "audio_format.h"
+
+#if AUDIO_CHANNELS != 2
+#error "mix kernels expect interleaved stereo frames"
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUDIO_MIX_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Audio {
+
+void clearFrames(float *out, int frames)
+{
+    std::memset(out, 0, frames * AUDIO_CHANNELS * sizeof(float));
+}
+
+void mixFrames(float *out, const float *in, int frames, float gain_from, float gain_to)
+{
+    if(frames <= 0)
+        return;
+
+    float step = (gain_to - gain_from) / frames;
+    int i = 0;
+
+#ifdef AUDIO_MIX_SSE2
+    // one vector holds two frames, gains of both frames differ by step
+    __m128 gain = _mm_setr_ps(gain_from + step, gain_from + step,
+                              gain_from + 2 * step, gain_from + 2 * step);
+    __m128 inc = _mm_set1_ps(2 * step);
+    for(; i + 2 <= frames; i += 2) {
+        __m128 o = _mm_loadu_ps(out + i * 2);
+        __m128 s = _mm_loadu_ps(in + i * 2);
+        _mm_storeu_ps(out + i * 2, _mm_add_ps(o, _mm_mul_ps(s, gain)));
+        gain = _mm_add_ps(gain, inc);
+    }
+#endif
+
+    for(; i < frames; ++i) {
+        float g = gain_from + step * (i + 1);
+        out[i * 2] += in[i * 2] * g;
+        out[i * 2 + 1] += in[i * 2 + 1] * g;
+    }
+}
+
+void scaleFrames(float *out, int frames, float gain_from, float gain_to)
+{
+    if(frames <= 0 || (gain_from == 1.0f && gain_to == 1.0f))
+        return;
+
+    float step = (gain_to - gain_from) / frames;
+    int i = 0;
+
+#ifdef AUDIO_MIX_SSE2
+    __m128 gain = _mm_setr_ps(gain_from + step, gain_from + step,
+                              gain_from + 2 * step, gain_from + 2 * step);
+    __m128 inc = _mm_set1_ps(2 * step);
+    for(; i + 2 <= frames; i += 2) {
+        __m128 o = _mm_loadu_ps(out + i * 2);
+        _mm_storeu_ps(out + i * 2, _mm_mul_ps(o, gain));
+        gain = _mm_add_ps(gain, inc);
+    }
+#endif
+
+    for(; i < frames; ++i) {
+        float g = gain_from + step * (i + 1);
+        out[i * 2] *= g;
+        out[i * 2 + 1] *= g;
+    }
+}
+
+void convertFrames(qint16 *out, const float *in, int frames)
+{
+    int samples = frames * AUDIO_CHANNELS;
+    int i = 0;
+
+#ifdef AUDIO_MIX_SSE2
+    __m128 lo = _mm_set1_ps(-1.0f);
+    __m128 hi = _mm_set1_ps(1.0f);
+    __m128 scale = _mm_set1_ps(32767.0f);
+    for(; i + 8 <= samples; i += 8) {
+        __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i), lo), hi);
+        __m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i + 4), lo), hi);
+        __m128i ia = _mm_cvtps_epi32(_mm_mul_ps(a, scale));
+        __m128i ib = _mm_cvtps_epi32(_mm_mul_ps(b, scale));
+        _mm_storeu_si128((__m128i*) (out + i), _mm_packs_epi32(ia, ib));
+    }
+#endif
+
+    for(; i < samples; ++i) {
+        float val = in[i];
+        if(val > 1.0f)
+            val = 1.0f;
+        else if(val < -1.0f)
+            val = -1.0f;
+        // round to nearest, like _mm_cvtps_epi32 (up to ties)
+        val *= 32767.0f;
+        out[i] = (qint16) (val < 0 ? val - 0.5f : val + 0.5f);
+    }
+}
+
+bool hasSimdKernels()
+{
+#ifdef AUDIO_MIX_SSE2
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace Audio
@@ -0,0 +1,31 @@
+#ifndef AUDIO_MIX_KERNELS_H
+#define AUDIO_MIX_KERNELS_H
+
+#include <QtGlobal>
+
+/*
+ * Float kernels of the mixer, working on interleaved stereo frames.
+ * SSE2 is used where available (all x86-64 builds), otherwise scalar code.
+ * Gains ramp linearly from gain_from to gain_to over the block,
+ * the last frame gets gain_to, so consecutive blocks join without steps.
+*/
+namespace Audio {
+
+/* out[i] = 0 for all samples of frames */
+void clearFrames(float* out, int frames);
+
+/* out[i] += in[i] * gain */
+void mixFrames(float* out, const float* in, int frames, float gain_from, float gain_to);
+
+/* out[i] *= gain */
+void scaleFrames(float* out, int frames, float gain_from, float gain_to);
+
+/* out[i] = in[i] clipped to [-1, 1] and converted to 16 bit */
+void convertFrames(qint16* out, const float* in, int frames);
+
+/* True if kernels use SIMD instructions */
+bool hasSimdKernels();
+
+} // namespace Audio
+
+#endif // AUDIO_MIX_KERNELS_H
@@ -0,0 +1,154 @@
+#include "mixer.h"
+
+#include <QDebug>
+#include <QCoreApplication>
+#include <QAudioFormat>
+#include <QAudioDeviceInfo>
+
+#include "audio_format.h"
+#include "mix_kernels.h"
+
+// size of the output buffer in frames (about 186 ms),
+// mixing runs in the GUI thread, so the buffer has to bridge
+// stalls of the event loop (layouting, painting, db queries)
+#define MIXER_BUFFER_FRAMES 8192
+
+namespace Audio {
+
+Mixer *Mixer::instance()
+{
+    static Mixer* mixer = 0;
+    if(mixer == 0)
+        mixer = new Mixer(QCoreApplication::instance());
+    return mixer;
+}
+
+Mixer::Mixer(QObject *parent)
+    : QIODevice(parent)
+    , output_(0)
+    , voices_()
+    , mix_buffer_()
+    , voice_buffer_()
+    , master_gain_(1)
+    , mixed_master_gain_(1)
+{}
+
+Mixer::~Mixer()
+{
+    if(output_)
+        output_->stop();
+}
+
+void Mixer::start()
+{
+    if(output_ != 0)
+        return;
+
+    QAudioFormat format;
+    format.setCodec("audio/pcm");
+    format.setSampleRate(AUDIO_SAMPLE_RATE);
+    format.setChannelCount(AUDIO_CHANNELS);
+    format.setSampleSize(16);
+    format.setSampleType(QAudioFormat::SignedInt);
+    format.setByteOrder(QAudioFormat::LittleEndian);
+
+    if(!QAudioDeviceInfo::defaultOutputDevice().isFormatSupported(format)) {
+        qDebug() << "FAILURE: Output format not supported by default audio device";
+        qDebug() << " > Format:" << format;
+    }
+
+    // output keeps running while the program runs, idle voices render silence
+    output_ = new QAudioOutput(format, this);
+    output_->setBufferSize(MIXER_BUFFER_FRAMES * AUDIO_CHANNELS * sizeof(qint16));
+
+    open(QIODevice::ReadOnly);
+    output_->start(this);
+
+    // backend may not accept the requested size
+    if(output_->bufferSize() < MIXER_BUFFER_FRAMES * AUDIO_CHANNELS * (int) sizeof(qint16)) {
+        qDebug() << "NOTIFICATION: Audio output buffer smaller than requested, playback may drop out";
+        qDebug() << " > Latency:" << getOutputLatency() << "ms";
+    }
+}
+
+void Mixer::addVoice(Voice *voice)
+{
+    if(voices_.contains(voice))
+        return;
+
+    // new voices start at their gain, without ramp
+    voice->mixed_gain_ = voice->gain_;
+    voices_.append(voice);
+}
+
+void Mixer::removeVoice(Voice *voice)
+{
+    voices_.removeOne(voice);
+}
+
+int Mixer::getVoiceCount() const
+{
+    return voices_.size();
+}
+
+void Mixer::setMasterVolume(int volume)
+{
+    master_gain_ = qBound(0, volume, 100) / 100.0f;
+}
+
+int Mixer::getMasterVolume() const
+{
+    return qRound(master_gain_ * 100);
+}
+
+double Mixer::getOutputLatency() const
+{
+    if(output_ == 0)
+        return 0;
+
+    int frames = output_->bufferSize() / (AUDIO_CHANNELS * sizeof(qint16));
+    return frames * 1000.0 / AUDIO_SAMPLE_RATE;
+}
+
+void Mixer::mix(float *out, int frames)
+{
+    clearFrames(out, frames);
+
+    if(voice_buffer_.size() < frames * AUDIO_CHANNELS)
+        voice_buffer_.resize(frames * AUDIO_CHANNELS);
+    float* buffer = voice_buffer_.data();
+
+    foreach(Voice* voice, voices_) {
+        voice->render(buffer, frames);
+
+        // muted voices still advance
+        if(voice->mixed_gain_ != 0 || voice->gain_ != 0)
+            mixFrames(out, buffer, frames, voice->mixed_gain_, voice->gain_);
+        voice->mixed_gain_ = voice->gain_;
+    }
+
+    scaleFrames(out, frames, mixed_master_gain_, master_gain_);
+    mixed_master_gain_ = master_gain_;
+}
+
+qint64 Mixer::readData(char *data, qint64 maxlen)
+{
+    int frames = (int) (maxlen / (AUDIO_CHANNELS * sizeof(qint16)));
+    if(frames <= 0)
+        return 0;
+
+    if(mix_buffer_.size() < frames * AUDIO_CHANNELS)
+        mix_buffer_.resize(frames * AUDIO_CHANNELS);
+
+    mix(mix_buffer_.data(), frames);
+    convertFrames((qint16*) data, mix_buffer_.constData(), frames);
+
+    return frames * AUDIO_CHANNELS * sizeof(qint16);
+}
+
+qint64 Mixer::writeData(const char*, qint64)
+{
+    return 0;
+}
+
+} // namespace Audio
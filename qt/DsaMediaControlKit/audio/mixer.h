@@ -0,0 +1,71 @@
+#ifndef AUDIO_MIXER_H
+#define AUDIO_MIXER_H
+
+#include <QIODevice>
+#include <QAudioOutput>
+#include <QList>
+#include <QVector>
+
+#include "voice.h"
+
+namespace Audio {
+
+/*
+ * Mixes all active voices into a single audio output stream.
+ * Each voice is scaled by its own gain, the sum by the master gain.
+ * The mixer is the pull source of the output, voices render
+ * in the thread owning the mixer (the GUI thread for instance()).
+ * Voices read streams fed by decoders of the same thread, so mixing
+ * stays in that thread. The output buffer is sized to cover stalls
+ * of the GUI event loop instead, at the cost of output latency
+ * (see getOutputLatency()).
+*/
+class Mixer : public QIODevice
+{
+    Q_OBJECT
+public:
+    /* Returns mixer of the audio output used by all players */
+    static Mixer* instance();
+
+    /* Mixer without output, used to mix offline (see mix()) */
+    Mixer(QObject* parent = 0);
+    virtual ~Mixer();
+
+    /* Opens audio output, if not running yet */
+    void start();
+
+    void addVoice(Voice* voice);
+    void removeVoice(Voice* voice);
+    int getVoiceCount() const;
+
+    /* master volume in percent (0 - 100) */
+    void setMasterVolume(int volume);
+    int getMasterVolume() const;
+
+    /* Returns time in ms between mixing a frame and hearing it (output buffer) */
+    double getOutputLatency() const;
+
+    /* Mixes frames of all voices into out (interleaved stereo) */
+    void mix(float* out, int frames);
+
+protected:
+    /*
+     * QIODevice overrides
+    */
+    virtual qint64 readData(char* data, qint64 maxlen);
+    virtual qint64 writeData(const char* data, qint64 len);
+
+private:
+    QAudioOutput* output_;
+
+    QList<Voice*> voices_;
+    QVector<float> mix_buffer_;
+    QVector<float> voice_buffer_;
+
+    float master_gain_;
+    float mixed_master_gain_;
+};
+
+} // namespace Audio
+
+#endif // AUDIO_MIXER_H
@@ -0,0 +1,207 @@
+#include "pcm_cache.h"
+
+#include <QDebug>
+#include <QCoreApplication>
+
+// default budget (256 MiB, about 12 minutes of stereo audio)
+#define PCM_CACHE_DEFAULT_BUDGET (256 * 1024 * 1024)
+// files decoded in parallel at most
+#define PCM_CACHE_MAX_LOADS 2
+
+namespace Audio {
+
+PcmCache *PcmCache::instance()
+{
+    static PcmCache* cache = 0;
+    if(cache == 0)
+        cache = new PcmCache(QCoreApplication::instance());
+    return cache;
+}
+
+void PcmCache::setBudget(qint64 bytes)
+{
+    budget_ = qMax(bytes, (qint64) 0);
+    evict();
+}
+
+qint64 PcmCache::getBudget() const
+{
+    return budget_;
+}
+
+qint64 PcmCache::getSize() const
+{
+    return size_;
+}
+
+bool PcmCache::contains(const QString &path) const
+{
+    return entries_.contains(path);
+}
+
+void PcmCache::preload(const QString &path)
+{
+    if(path.isEmpty() || entries_.contains(path))
+        return;
+    if(loading_.contains(path) || load_queue_.contains(path))
+        return;
+
+    load_queue_.append(path);
+    startLoads();
+}
+
+void PcmCache::pin(const QString &path)
+{
+    ++pins_[path];
+    preload(path);
+}
+
+void PcmCache::unpin(const QString &path)
+{
+    QHash<QString, int>::iterator it = pins_.find(path);
+    if(it == pins_.end())
+        return;
+
+    if(--it.value() <= 0) {
+        pins_.erase(it);
+        evict();
+    }
+}
+
+PcmStream *PcmCache::createStream(const QString &path, QObject *parent)
+{
+    QHash<QString, Entry>::iterator it = entries_.find(path);
+    if(it == entries_.end())
+        return new PcmStream(path, parent);
+
+    it.value().last_use = ++use_count_;
+    return new PcmStream(path, it.value().samples, parent);
+}
+
+void PcmCache::onDecoded()
+{
+    PcmStream* stream = qobject_cast<PcmStream*>(sender());
+    if(stream == 0)
+        return;
+
+    QString path = stream->getPath();
+    loading_.remove(path);
+    stream->deleteLater();
+
+    if(!stream->hasError()) {
+        Entry entry;
+        entry.samples = stream->getSamples();
+        // drop spare capacity from decoding (copies once, stream still shares)
+        entry.samples.squeeze();
+        entry.bytes = (qint64) entry.samples.size() * sizeof(float);
+        entry.last_use = ++use_count_;
+
+        bool pinned = pins_.contains(path);
+        if(!pinned && entry.bytes > getUnpinnedBudget()) {
+            qDebug() << "NOTIFICATION: Sound file exceeds audio cache budget, not cached";
+            qDebug() << " > File:" << path << "(" << entry.bytes << "bytes )";
+        } else {
+            entries_.insert(path, entry);
+            size_ += entry.bytes;
+            evict();
+
+            if(pinned && size_ > budget_) {
+                qDebug() << "NOTIFICATION: Pinned sound files exceed audio cache budget";
+                qDebug() << " > Cache size:" << size_ << "bytes, budget:" << budget_ << "bytes";
+            }
+            if(entries_.contains(path))
+                emit loaded(path);
+        }
+    }
+
+    startLoads();
+}
+
+void PcmCache::onProgress()
+{
+    PcmStream* stream = qobject_cast<PcmStream*>(sender());
+    if(stream == 0)
+        return;
+
+    QString path = stream->getPath();
+    if(pins_.contains(path))
+        return;
+
+    // file would not be cached anyway, stop decoding it right away
+    qint64 bytes = (qint64) stream->getSamples().size() * sizeof(float);
+    if(bytes <= getUnpinnedBudget())
+        return;
+
+    qDebug() << "NOTIFICATION: Sound file exceeds audio cache budget, loading aborted";
+    qDebug() << " > File:" << path << "(" << bytes << "bytes decoded )";
+
+    loading_.remove(path);
+    stream->disconnect(this);
+    stream->deleteLater();
+
+    startLoads();
+}
+
+PcmCache::PcmCache(QObject *parent)
+    : QObject(parent)
+    , entries_()
+    , pins_()
+    , load_queue_()
+    , loading_()
+    , budget_(PCM_CACHE_DEFAULT_BUDGET)
+    , size_(0)
+    , use_count_(0)
+{}
+
+void PcmCache::startLoads()
+{
+    while(loading_.size() < PCM_CACHE_MAX_LOADS && !load_queue_.isEmpty()) {
+        QString path = load_queue_.takeFirst();
+
+        // stream is never read, so it keeps all decoded samples
+        PcmStream* stream = new PcmStream(path, this);
+        stream->setHighWaterMark(0);
+        connect(stream, SIGNAL(decoded()),
+                this, SLOT(onDecoded()));
+        connect(stream, SIGNAL(progress()),
+                this, SLOT(onProgress()));
+        loading_.insert(path, stream);
+        stream->start();
+    }
+}
+
+void PcmCache::evict()
+{
+    while(size_ > budget_) {
+        // least recently used file, which is not pinned
+        QHash<QString, Entry>::iterator lru = entries_.end();
+        QHash<QString, Entry>::iterator it = entries_.begin();
+        for(; it != entries_.end(); ++it) {
+            if(pins_.contains(it.key()))
+                continue;
+            if(lru == entries_.end() || it.value().last_use < lru.value().last_use)
+                lru = it;
+        }
+
+        // only pinned files left
+        if(lru == entries_.end())
+            return;
+
+        size_ -= lru.value().bytes;
+        entries_.erase(lru);
+    }
+}
+
+qint64 PcmCache::getUnpinnedBudget() const
+{
+    qint64 budget = budget_;
+    QHash<QString, int>::const_iterator it = pins_.begin();
+    for(; it != pins_.end(); ++it) {
+        QHash<QString, Entry>::const_iterator entry = entries_.find(it.key());
+        if(entry != entries_.end())
+            budget -= entry.value().bytes;
+    }
+    return budget;
+}
+
+} // namespace Audio
@@ -0,0 +1,102 @@
+#ifndef AUDIO_PCM_CACHE_H
+#define AUDIO_PCM_CACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+
+#include "pcm_stream.h"
+
+namespace Audio {
+
+/*
+ * Keeps decoded PCM of sound files in memory, so they play without
+ * reading and decoding the file again.
+ * Files are decoded in the background on preload().
+ * Memory is bound by a byte budget, least recently used files are evicted
+ * first. Pinned files are never evicted (they still count against the budget).
+ * Loading a file, which is not pinned, is aborted as soon as its decoded
+ * samples exceed the budget left by pinned files.
+ * Streams created from cached PCM share the samples, so evicting a file
+ * while it plays frees its memory once the stream is done.
+*/
+class PcmCache : public QObject
+{
+    Q_OBJECT
+public:
+    /* Returns cache used by all players */
+    static PcmCache* instance();
+
+    /* budget in bytes, evicts files if cache exceeds new budget */
+    void setBudget(qint64 bytes);
+    qint64 getBudget() const;
+
+    /* bytes held by cached files */
+    qint64 getSize() const;
+
+    bool contains(QString const& path) const;
+
+    /* Decodes file into cache in background, if not cached yet */
+    void preload(QString const& path);
+
+    /*
+     * Pins file, so it is not evicted (preloads file).
+     * Pins are counted, each pin() needs a matching unpin().
+    */
+    void pin(QString const& path);
+    void unpin(QString const& path);
+
+    /*
+     * Creates stream of file with given parent.
+     * The stream reads from memory if file is cached, otherwise it decodes the file.
+    */
+    PcmStream* createStream(QString const& path, QObject* parent);
+
+signals:
+    /* file has been decoded and added to the cache */
+    void loaded(QString const& path);
+
+private slots:
+    void onDecoded();
+    void onProgress();
+
+private:
+    PcmCache(QObject* parent = 0);
+
+    /* starts decoding queued files, up to the maximum of parallel loads */
+    void startLoads();
+
+    /* evicts least recently used files, until cache fits into budget */
+    void evict();
+
+    /* budget left by pinned files, which are cached */
+    qint64 getUnpinnedBudget() const;
+
+    struct Entry {
+        QVector<float> samples;
+        qint64 bytes;
+        quint64 last_use;
+
+        Entry()
+            : samples()
+            , bytes(0)
+            , last_use(0)
+        {}
+    };
+
+    QHash<QString, Entry> entries_;
+    QHash<QString, int> pins_;
+
+    // files waiting for and in decoding
+    QStringList load_queue_;
+    QHash<QString, PcmStream*> loading_;
+
+    qint64 budget_;
+    qint64 size_;
+    quint64 use_count_;
+};
+
+} // namespace Audio
+
+#endif // AUDIO_PCM_CACHE_H
@@ -0,0 +1,311 @@
+#include "pcm_stream.h"
+
+#include <QDebug>
+#include <QAudioFormat>
+#include <cmath>
+#include <cstring>
+
+// read samples get dropped from the queue once they exceed this count
+#define PCM_STREAM_COMPACT_SAMPLES 65536
+// frames decoded ahead of reading at most by default (10 seconds)
+#define PCM_STREAM_HIGH_WATER (10 * AUDIO_SAMPLE_RATE)
+
+namespace Audio {
+
+PcmStream::PcmStream(const QString &path, QObject *parent)
+    : QObject(parent)
+    , path_(path)
+    , decoder_(0)
+    , samples_()
+    , read_pos_(0)
+    , lookahead_(AUDIO_SAMPLE_RATE)
+    , high_water_(PCM_STREAM_HIGH_WATER)
+    , finished_(false)
+    , decoded_(false)
+    , error_(false)
+    , ready_emitted_(false)
+    , resample_pos_(0)
+    , has_last_frame_(false)
+{
+    for(int c = 0; c < AUDIO_CHANNELS; ++c)
+        last_frame_[c] = 0;
+
+    QAudioFormat format;
+    format.setCodec("audio/pcm");
+    format.setSampleRate(AUDIO_SAMPLE_RATE);
+    format.setChannelCount(AUDIO_CHANNELS);
+    format.setSampleSize(32);
+    format.setSampleType(QAudioFormat::Float);
+    format.setByteOrder(QAudioFormat::LittleEndian);
+
+    decoder_ = new QAudioDecoder(this);
+    decoder_->setAudioFormat(format);
+    decoder_->setSourceFilename(path_);
+
+    connect(decoder_, SIGNAL(bufferReady()),
+            this, SLOT(onBufferReady()));
+    connect(decoder_, SIGNAL(finished()),
+            this, SLOT(onFinished()));
+    connect(decoder_, SIGNAL(error(QAudioDecoder::Error)),
+            this, SLOT(onError(QAudioDecoder::Error)));
+}
+
+PcmStream::PcmStream(const QString &path, const QVector<float> &samples, QObject *parent)
+    : QObject(parent)
+    , path_(path)
+    , decoder_(0)
+    , samples_(samples)
+    , read_pos_(0)
+    , lookahead_(AUDIO_SAMPLE_RATE)
+    , high_water_(PCM_STREAM_HIGH_WATER)
+    , finished_(true)
+    , decoded_(true)
+    , error_(false)
+    , ready_emitted_(true)
+    , resample_pos_(0)
+    , has_last_frame_(false)
+{
+    for(int c = 0; c < AUDIO_CHANNELS; ++c)
+        last_frame_[c] = 0;
+}
+
+PcmStream::~PcmStream()
+{
+    if(decoder_)
+        decoder_->stop();
+}
+
+const QString &PcmStream::getPath() const
+{
+    return path_;
+}
+
+void PcmStream::setLookahead(int frames)
+{
+    lookahead_ = frames;
+    checkReady();
+}
+
+void PcmStream::setHighWaterMark(int frames)
+{
+    high_water_ = qMax(frames, 0);
+    resume();
+}
+
+void PcmStream::start()
+{
+    if(decoder_)
+        decoder_->start();
+}
+
+bool PcmStream::isFromMemory() const
+{
+    return decoder_ == 0;
+}
+
+int PcmStream::read(float *out, int frames)
+{
+    frames = qMax(qMin(frames, getAvailable()), 0);
+
+    // also when nothing is read, a reader waiting for frames
+    // would never see the buffers left at the high water mark
+    if(frames == 0) {
+        resume();
+        return 0;
+    }
+
+    int count = frames * AUDIO_CHANNELS;
+    std::memcpy(out, samples_.constData() + read_pos_, count * sizeof(float));
+    read_pos_ += count;
+
+    // drop read samples, so memory is bound by the decoded lookahead
+    // (shared samples stay untouched, removing would copy them)
+    if(decoder_ && read_pos_ >= PCM_STREAM_COMPACT_SAMPLES && read_pos_ * 2 >= samples_.size()) {
+        samples_.remove(0, read_pos_);
+        read_pos_ = 0;
+    }
+
+    resume();
+
+    return frames;
+}
+
+int PcmStream::getAvailable() const
+{
+    return (samples_.size() - read_pos_) / AUDIO_CHANNELS;
+}
+
+bool PcmStream::isReady() const
+{
+    return decoded_ || getAvailable() >= lookahead_;
+}
+
+bool PcmStream::isDecoded() const
+{
+    return decoded_;
+}
+
+bool PcmStream::atEnd() const
+{
+    return decoded_ && getAvailable() == 0;
+}
+
+bool PcmStream::hasError() const
+{
+    return error_;
+}
+
+const QVector<float> &PcmStream::getSamples() const
+{
+    return samples_;
+}
+
+void PcmStream::onBufferReady()
+{
+    int size = samples_.size();
+    fetch();
+    checkReady();
+
+    if(samples_.size() != size)
+        emit progress();
+}
+
+void PcmStream::onFinished()
+{
+    finished_ = true;
+    fetch();
+
+    // buffers left above the high water mark are taken by read()
+    if(decoded_ || decoder_->bufferAvailable())
+        return;
+
+    decoded_ = true;
+    checkReady();
+    emit decoded();
+}
+
+void PcmStream::onError(QAudioDecoder::Error error)
+{
+    qDebug() << "FAILURE: Could not decode sound file";
+    qDebug() << " > File:" << path_;
+    qDebug() << " > Error:" << error << decoder_->errorString();
+
+    error_ = true;
+    decoded_ = true;
+    checkReady();
+    emit decoded();
+}
+
+void PcmStream::fetch()
+{
+    // buffers above the high water mark stay queued in the decoder,
+    // backends with a bounded queue pause decoding until they are read
+    while(decoder_->bufferAvailable() && !isAboveHighWater())
+        append(decoder_->read());
+}
+
+void PcmStream::resume()
+{
+    // take buffers left in the decoder at the high water mark
+    if(decoder_ == 0 || decoded_ || isAboveHighWater())
+        return;
+
+    fetch();
+
+    // finish outside of read(), which runs within mixing
+    if(finished_ && !decoder_->bufferAvailable())
+        QMetaObject::invokeMethod(this, "onFinished", Qt::QueuedConnection);
+}
+
+bool PcmStream::isAboveHighWater() const
+{
+    return high_water_ > 0 && getAvailable() >= qMax(high_water_, lookahead_);
+}
+
+void PcmStream::append(const QAudioBuffer &buffer)
+{
+    if(!buffer.isValid())
+        return;
+
+    QAudioFormat format = buffer.format();
+    int channels = format.channelCount();
+    int frames = buffer.frameCount();
+    if(channels <= 0 || frames <= 0)
+        return;
+
+    QVector<float> converted(frames * AUDIO_CHANNELS);
+    float* dst = converted.data();
+
+    for(int i = 0; i < frames; ++i) {
+        for(int c = 0; c < AUDIO_CHANNELS; ++c) {
+            // mono is copied to both channels, further channels are dropped
+            int src = i * channels + qMin(c, channels - 1);
+            float val = 0;
+
+            if(format.sampleType() == QAudioFormat::Float && format.sampleSize() == 32) {
+                val = buffer.constData<float>()[src];
+            } else if(format.sampleType() == QAudioFormat::SignedInt && format.sampleSize() == 16) {
+                val = buffer.constData<qint16>()[src] / 32768.0f;
+            } else if(format.sampleType() == QAudioFormat::SignedInt && format.sampleSize() == 32) {
+                val = buffer.constData<qint32>()[src] / 2147483648.0f;
+            } else if(format.sampleType() == QAudioFormat::UnSignedInt && format.sampleSize() == 8) {
+                val = (buffer.constData<quint8>()[src] - 128) / 128.0f;
+            } else {
+                qDebug() << "FAILURE: Unsupported sample format of decoded buffer";
+                qDebug() << " > File:" << path_;
+                qDebug() << " > Format:" << format;
+                return;
+            }
+
+            dst[i * AUDIO_CHANNELS + c] = val;
+        }
+    }
+
+    appendResampled(converted, format.sampleRate());
+}
+
+void PcmStream::appendResampled(const QVector<float> &frames, int sample_rate)
+{
+    if(sample_rate == AUDIO_SAMPLE_RATE || sample_rate <= 0) {
+        samples_ += frames;
+        return;
+    }
+
+    // linear interpolation, last frame of previous buffer is frame 0
+    QVector<float> src;
+    if(has_last_frame_) {
+        for(int c = 0; c < AUDIO_CHANNELS; ++c)
+            src.append(last_frame_[c]);
+    }
+    src += frames;
+
+    int src_frames = src.size() / AUDIO_CHANNELS;
+    double step = (double) sample_rate / AUDIO_SAMPLE_RATE;
+    double pos = resample_pos_;
+
+    while(pos + 1 < src_frames) {
+        int i = (int) std::floor(pos);
+        float f = (float) (pos - i);
+        for(int c = 0; c < AUDIO_CHANNELS; ++c) {
+            float a = src[i * AUDIO_CHANNELS + c];
+            float b = src[(i + 1) * AUDIO_CHANNELS + c];
+            samples_.append(a + (b - a) * f);
+        }
+        pos += step;
+    }
+
+    resample_pos_ = pos - (src_frames - 1);
+    for(int c = 0; c < AUDIO_CHANNELS; ++c)
+        last_frame_[c] = src[(src_frames - 1) * AUDIO_CHANNELS + c];
+    has_last_frame_ = true;
+}
+
+void PcmStream::checkReady()
+{
+    if(!ready_emitted_ && isReady()) {
+        ready_emitted_ = true;
+        emit ready();
+    }
+}
+
+} // namespace Audio
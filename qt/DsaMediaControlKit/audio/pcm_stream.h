@@ -0,0 +1,141 @@
+#ifndef AUDIO_PCM_STREAM_H
+#define AUDIO_PCM_STREAM_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QAudioDecoder>
+#include <QAudioBuffer>
+
+#include "audio_format.h"
+
+namespace Audio {
+
+/*
+ * Decodes a sound file into PCM of the engine format.
+ * Decoding runs ahead of playback, decoded frames are queued
+ * until read, so a stream can be opened before it is played.
+ * Decoding stays at most a high water mark ahead of reading,
+ * further buffers are left in the decoder until read() catches up.
+ * Buffers of other sample rates or channel counts are converted,
+ * if the decoder backend ignores the requested format.
+*/
+class PcmStream : public QObject
+{
+    Q_OBJECT
+public:
+    PcmStream(QString const& path, QObject* parent = 0);
+
+    /*
+     * Stream reading already decoded samples of path (see PcmCache).
+     * Samples are shared, not copied.
+    */
+    PcmStream(QString const& path, QVector<float> const& samples, QObject* parent = 0);
+    virtual ~PcmStream();
+
+    QString const& getPath() const;
+
+    /*
+     * Number of frames, which have to be decoded ahead
+     * before the stream counts as ready.
+    */
+    void setLookahead(int frames);
+
+    /*
+     * Number of frames decoded ahead of reading at most
+     * (never less than the lookahead). Readers which keep frames
+     * unread (e.g. for a crossfade) have to raise it above these frames,
+     * otherwise decoding stops for good. 0 decodes the whole file
+     * without limit, for streams which are never read (see PcmCache).
+    */
+    void setHighWaterMark(int frames);
+
+    /* Opens file and starts decoding (nothing to do for decoded samples) */
+    void start();
+
+    /* True if stream reads already decoded samples */
+    bool isFromMemory() const;
+
+    /*
+     * Reads up to frames frames (interleaved) into out.
+     * Returns number of frames read.
+    */
+    int read(float* out, int frames);
+
+    /* Returns number of decoded frames not read yet */
+    int getAvailable() const;
+
+    /* True if lookahead is decoded or decoding ended */
+    bool isReady() const;
+
+    /* True if whole file has been decoded (or decoding failed) */
+    bool isDecoded() const;
+
+    /* True if all decoded frames have been read and decoding ended */
+    bool atEnd() const;
+
+    bool hasError() const;
+
+    /*
+     * Returns decoded samples.
+     * Holds the whole file only if nothing has been read.
+    */
+    QVector<float> const& getSamples() const;
+
+signals:
+    /* emitted once, when stream becomes ready */
+    void ready();
+
+    /* emitted once, when decoding ended (see hasError()) */
+    void decoded();
+
+    /* emitted when decoded frames have been added */
+    void progress();
+
+private slots:
+    void onBufferReady();
+    void onFinished();
+    void onError(QAudioDecoder::Error error);
+
+private:
+    /* reads buffers the decoder holds, up to the high water mark */
+    void fetch();
+
+    /* fetches buffers left in the decoder, once below the high water mark */
+    void resume();
+
+    /* true if decoded frames not read yet reach the high water mark */
+    bool isAboveHighWater() const;
+
+    /* converts buffer to engine format and appends it */
+    void append(QAudioBuffer const& buffer);
+
+    /* appends stereo frames of given sample rate, resampling if needed */
+    void appendResampled(QVector<float> const& frames, int sample_rate);
+
+    /* emits ready() if stream became ready */
+    void checkReady();
+
+    QString path_;
+    // 0 if stream reads decoded samples
+    QAudioDecoder* decoder_;
+
+    QVector<float> samples_;
+    int read_pos_;
+    int lookahead_;
+    int high_water_;
+    // decoder finished, buffers may still be left in it
+    bool finished_;
+    bool decoded_;
+    bool error_;
+    bool ready_emitted_;
+
+    // resampler state, position relative to last_frame_
+    double resample_pos_;
+    float last_frame_[AUDIO_CHANNELS];
+    bool has_last_frame_;
+};
+
+} // namespace Audio
+
+#endif // AUDIO_PCM_STREAM_H
@@ -0,0 +1,315 @@
+#include "playback_engine.h"
+#include "mixer.h"
+#include "mix_kernels.h"
+#include "pcm_cache.h"
+
+#include <QDebug>
+#include <QtMath>
+#include <cmath>
+
+// frames decoded ahead of a queued file, on top of the crossfade length
+#define PLAYBACK_ENGINE_LOOKAHEAD (AUDIO_SAMPLE_RATE / 2)
+// frames decoded ahead of playback at most, on top of the crossfade length
+// (render() keeps the crossfade length unread until the file is decoded)
+#define PLAYBACK_ENGINE_HIGH_WATER (10 * AUDIO_SAMPLE_RATE)
+
+namespace Audio {
+
+PlaybackEngine::PlaybackEngine(QObject *parent)
+    : QObject(parent)
+    , Voice()
+    , current_(0)
+    , next_(0)
+    , gap_frames_(0)
+    , crossfade_frames_(0)
+    , fade_pos_(0)
+    , fade_length_(0)
+    , fade_buffer_()
+    , started_count_(0)
+    , finished_count_(0)
+    , all_finished_(false)
+    , emit_pending_(false)
+    , start_timer_()
+    , measure_latency_(false)
+    , latency_pending_(false)
+    , latency_(0)
+    , latency_from_memory_(false)
+{}
+
+PlaybackEngine::~PlaybackEngine()
+{
+    stop();
+}
+
+void PlaybackEngine::start(const QString &path)
+{
+    dropStream(current_);
+    dropStream(next_);
+    gap_frames_ = 0;
+    fade_length_ = 0;
+
+    current_ = createStream(path);
+
+    start_timer_.start();
+    measure_latency_ = true;
+    latency_from_memory_ = current_->isFromMemory();
+
+    Mixer::instance()->start();
+    Mixer::instance()->addVoice(this);
+
+    emit trackStarted();
+}
+
+void PlaybackEngine::queue(const QString &path, int gap_frames)
+{
+    // queued file is part of a running crossfade
+    if(fade_length_ > 0)
+        return;
+
+    dropStream(next_);
+    next_ = createStream(path);
+    next_->setLookahead(crossfade_frames_ + PLAYBACK_ENGINE_LOOKAHEAD);
+    gap_frames_ = qMax(gap_frames, 0);
+}
+
+void PlaybackEngine::clearQueue()
+{
+    if(fade_length_ > 0)
+        return;
+
+    dropStream(next_);
+    gap_frames_ = 0;
+}
+
+void PlaybackEngine::stop()
+{
+    Mixer::instance()->removeVoice(this);
+
+    dropStream(current_);
+    dropStream(next_);
+    gap_frames_ = 0;
+    fade_length_ = 0;
+
+    // transitions rendered before stopping are not reported anymore
+    started_count_ = 0;
+    finished_count_ = 0;
+    all_finished_ = false;
+    measure_latency_ = false;
+    latency_pending_ = false;
+}
+
+bool PlaybackEngine::isActive() const
+{
+    return current_ != 0 || next_ != 0;
+}
+
+bool PlaybackEngine::isFading() const
+{
+    return fade_length_ > 0;
+}
+
+void PlaybackEngine::setVolume(int volume)
+{
+    setGain(qBound(0, volume, 100) / 100.0f);
+}
+
+void PlaybackEngine::setCrossfade(int frames)
+{
+    crossfade_frames_ = qMax(frames, 0);
+    if(current_)
+        current_->setHighWaterMark(crossfade_frames_ + PLAYBACK_ENGINE_HIGH_WATER);
+    if(next_) {
+        next_->setLookahead(crossfade_frames_ + PLAYBACK_ENGINE_LOOKAHEAD);
+        next_->setHighWaterMark(crossfade_frames_ + PLAYBACK_ENGINE_HIGH_WATER);
+    }
+}
+
+int PlaybackEngine::getCrossfade() const
+{
+    return crossfade_frames_;
+}
+
+void PlaybackEngine::emitPending()
+{
+    emit_pending_ = false;
+
+    int finished_count = finished_count_;
+    int started_count = started_count_;
+    bool all_finished = all_finished_;
+    finished_count_ = 0;
+    started_count_ = 0;
+    all_finished_ = false;
+
+    for(int i = 0; i < finished_count; ++i)
+        emit trackFinished();
+    for(int i = 0; i < started_count; ++i)
+        emit trackStarted();
+    if(all_finished)
+        emit finished();
+
+    if(latency_pending_) {
+        latency_pending_ = false;
+        qDebug() << "NOTIFICATION: Trigger-to-audio latency" << latency_ << "ms"
+                 << (latency_from_memory_ ? "(cached)" : "(decoded)");
+        emit latencyMeasured(latency_, latency_from_memory_);
+    }
+}
+
+void PlaybackEngine::render(float *out, int frames)
+{
+    clearFrames(out, frames);
+
+    int pos = 0;
+    while(pos < frames) {
+        float* dst = out + pos * AUDIO_CHANNELS;
+        int todo = frames - pos;
+
+        if(current_ == 0) {
+            if(next_ == 0)
+                break;
+
+            // silence between files
+            if(gap_frames_ > 0) {
+                int n = qMin(gap_frames_, todo);
+                gap_frames_ -= n;
+                pos += n;
+                continue;
+            }
+
+            // queued file not decoded in time, gap grows
+            if(!next_->isReady())
+                break;
+
+            current_ = next_;
+            next_ = 0;
+            ++started_count_;
+            continue;
+        }
+
+        if(fade_length_ > 0) {
+            pos += renderCrossfade(dst, todo);
+            continue;
+        }
+
+        int avail = current_->getAvailable();
+        bool fade = canCrossfade();
+
+        // start of crossfade is only known once the current file is decoded
+        if(!current_->isDecoded()) {
+            int reserve = crossfade_frames_;
+            int n = current_->read(dst, qMin(todo, qMax(avail - reserve, 0)));
+            if(n > 0)
+                checkLatency(pos);
+            pos += n;
+            if(n < todo)
+                break; // decoder underrun
+            continue;
+        }
+
+        if(fade && avail > 0 && avail <= crossfade_frames_) {
+            fade_length_ = avail;
+            fade_pos_ = 0;
+            continue;
+        }
+
+        int n = current_->read(dst, fade ? qMin(todo, avail - crossfade_frames_) : todo);
+        if(n > 0)
+            checkLatency(pos);
+        pos += n;
+
+        if(current_->atEnd())
+            endCurrent();
+    }
+
+    // receivers may queue the following file, so emit once mixing is done
+    bool pending = started_count_ > 0 || finished_count_ > 0
+            || all_finished_ || latency_pending_;
+    if(pending && !emit_pending_) {
+        emit_pending_ = true;
+        QMetaObject::invokeMethod(this, "emitPending", Qt::QueuedConnection);
+    }
+}
+
+int PlaybackEngine::renderCrossfade(float *out, int frames)
+{
+    int n = current_->read(out, qMin(frames, fade_length_ - fade_pos_));
+
+    if(fade_buffer_.size() < n * AUDIO_CHANNELS)
+        fade_buffer_.resize(n * AUDIO_CHANNELS);
+    float* in = fade_buffer_.data();
+
+    // queued file was decoded ahead by at least the fade length
+    int m = next_->read(in, n);
+    for(int i = m * AUDIO_CHANNELS; i < n * AUDIO_CHANNELS; ++i)
+        in[i] = 0;
+
+    // equal power: gains follow a quarter sine/cosine, so summed power stays constant
+    for(int i = 0; i < n; ++i) {
+        double t = (fade_pos_ + i + 0.5) / fade_length_ * M_PI / 2.0;
+        float g_out = (float) std::cos(t);
+        float g_in = (float) std::sin(t);
+        for(int c = 0; c < AUDIO_CHANNELS; ++c) {
+            int s = i * AUDIO_CHANNELS + c;
+            out[s] = out[s] * g_out + in[s] * g_in;
+        }
+    }
+    fade_pos_ += n;
+
+    if(current_->atEnd() || n == 0) {
+        // queued file has been playing since start of the fade
+        fade_length_ = 0;
+        endCurrent();
+        current_ = next_;
+        next_ = 0;
+        ++started_count_;
+    }
+
+    return n;
+}
+
+bool PlaybackEngine::canCrossfade() const
+{
+    return crossfade_frames_ > 0 && next_ != 0
+            && gap_frames_ == 0 && next_->isReady();
+}
+
+void PlaybackEngine::endCurrent()
+{
+    dropStream(current_);
+    ++finished_count_;
+
+    if(next_ == 0)
+        all_finished_ = true;
+}
+
+void PlaybackEngine::checkLatency(int pos)
+{
+    if(!measure_latency_)
+        return;
+
+    // frame at pos is heard after the frames before it and the output buffer
+    measure_latency_ = false;
+    latency_pending_ = true;
+    latency_ = start_timer_.nsecsElapsed() / 1e6
+            + pos * 1000.0 / AUDIO_SAMPLE_RATE
+            + Mixer::instance()->getOutputLatency();
+}
+
+PcmStream *PlaybackEngine::createStream(const QString &path)
+{
+    PcmStream* stream = PcmCache::instance()->createStream(path, this);
+    stream->setHighWaterMark(crossfade_frames_ + PLAYBACK_ENGINE_HIGH_WATER);
+    stream->start();
+    return stream;
+}
+
+void PlaybackEngine::dropStream(PcmStream *&stream)
+{
+    if(stream == 0)
+        return;
+
+    stream->deleteLater();
+    stream = 0;
+}
+
+} // namespace Audio
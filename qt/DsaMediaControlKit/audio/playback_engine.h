@@ -0,0 +1,126 @@
+#ifndef AUDIO_PLAYBACK_ENGINE_H
+#define AUDIO_PLAYBACK_ENGINE_H
+
+#include <QObject>
+#include <QVector>
+#include <QElapsedTimer>
+
+#include "pcm_stream.h"
+#include "voice.h"
+
+namespace Audio {
+
+/*
+ * Plays a sequence of sound files without gaps between them.
+ * The file following the current one is queued ahead of time,
+ * so it is opened and decoded while the current one plays.
+ * Transitions are sample accurate: the queued file starts on the frame
+ * after the current one ended (or after the given number of silent frames),
+ * optionally with an equal-power crossfade.
+ * While active, the engine is a voice of the shared Mixer.
+*/
+class PlaybackEngine : public QObject, public Voice
+{
+    Q_OBJECT
+public:
+    PlaybackEngine(QObject* parent = 0);
+    virtual ~PlaybackEngine();
+
+    /* Starts playing file immediately, drops queued file */
+    void start(QString const& path);
+
+    /*
+     * Queues file to be played gap_frames after the current file ended.
+     * Replaces previously queued file.
+    */
+    void queue(QString const& path, int gap_frames = 0);
+    void clearQueue();
+
+    /* Stops playback and drops all files */
+    void stop();
+
+    /* True if a file is playing or queued */
+    bool isActive() const;
+
+    /* True while current file fades into the queued one, queue is fixed then */
+    bool isFading() const;
+
+    /* volume in percent (0 - 100) */
+    void setVolume(int volume);
+
+    /*
+     * Length of the crossfade between current and queued file in frames.
+     * 0 disables crossfades. Files queued with a gap are never crossfaded.
+    */
+    void setCrossfade(int frames);
+    int getCrossfade() const;
+
+    /* Voice override */
+    virtual void render(float* out, int frames);
+
+signals:
+    /* a file started playing (also emitted for queued files) */
+    void trackStarted();
+
+    /* a file played to its end */
+    void trackFinished();
+
+    /* last file ended and nothing is queued */
+    void finished();
+
+    /*
+     * Time from start() until the first frame of the file is audible in ms
+     * (including the output buffer of the mixer).
+    */
+    void latencyMeasured(double ms, bool from_memory);
+
+private slots:
+    /* emits signals collected while rendering */
+    void emitPending();
+
+private:
+    /* renders crossfade of current and queued file, returns frames rendered */
+    int renderCrossfade(float* out, int frames);
+
+    /* True if current file can fade into the queued one */
+    bool canCrossfade() const;
+
+    /* drops current file, after it played to its end */
+    void endCurrent();
+
+    /* measures latency, if first frames of a started file were rendered at pos */
+    void checkLatency(int pos);
+
+    /* creates stream for path (from PcmCache, if cached) */
+    PcmStream* createStream(QString const& path);
+
+    /* deletes stream (deferred, may be called while rendering) */
+    void dropStream(PcmStream*& stream);
+
+    PcmStream* current_;
+    PcmStream* next_;
+    int gap_frames_;
+
+    int crossfade_frames_;
+    int fade_pos_;
+    int fade_length_;
+
+    QVector<float> fade_buffer_;
+
+    // signals collected while rendering, emitted afterwards
+    int started_count_;
+    int finished_count_;
+    bool all_finished_;
+    bool emit_pending_;
+
+    // trigger-to-audio latency of the last start()
+    QElapsedTimer start_timer_;
+    bool measure_latency_;
+    bool latency_pending_;
+    double latency_;
+    bool latency_from_memory_;
+};
+
+} // namespace Audio
+
+#endif // AUDIO_PLAYBACK_ENGINE_H
@@ -0,0 +1,42 @@
+#ifndef AUDIO_VOICE_H
+#define AUDIO_VOICE_H
+
+namespace Audio {
+
+/*
+ * Source of audio mixed by the Mixer.
+ * Gain is applied by the mixer, changes are ramped over one block.
+*/
+class Voice
+{
+public:
+    Voice()
+        : gain_(1)
+        , mixed_gain_(1)
+    {}
+
+    virtual ~Voice()
+    {}
+
+    /* linear gain (1 = unchanged) */
+    void setGain(float gain) { gain_ = gain; }
+    float getGain() const { return gain_; }
+
+    /*
+     * Renders frames into out (interleaved stereo, engine format).
+     * out has to be overwritten entirely, fill silence if nothing plays.
+     * Called from the thread owning the mixer.
+    */
+    virtual void render(float* out, int frames) = 0;
+
+private:
+    friend class Mixer;
+
+    float gain_;
+    // gain applied at the end of the previous block
+    float mixed_gain_;
+};
+
+} // namespace Audio
+
+#endif // AUDIO_VOICE_H
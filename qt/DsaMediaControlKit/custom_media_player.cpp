@@ -1,88 +1,76 @@
 #include "custom_media_player.h"
-#include <random>
+
+#include <QDebug>
+
+#include "misc/random_service.h"
 
 CustomMediaPlayer::CustomMediaPlayer(QObject* parent)
-    : QMediaPlayer(parent)
+    : QObject(parent)
+    , engine_(0)
+    , playlist_(0)
     , activated_(false)
-    , current_content_index_(0)
-    , delay_flag_(false)
-    , delay_(0)
-    , delay_timer_(0)
+    , current_index_(-1)
+    , queued_index_(-1)
+    , random_plays_(0)
 {
-    delay_timer_ = new QTimer(this);
-    connect(delay_timer_, SIGNAL(timeout()),
-            this, SLOT(delayIsOver()));
+    engine_ = new Audio::PlaybackEngine(this);
 
+    connect(engine_, SIGNAL(trackStarted()),
+            this, SLOT(onTrackStarted()));
+    connect(engine_, SIGNAL(finished()),
+            this, SLOT(onFinished()));
 }
 
 void CustomMediaPlayer::play()
 {
-
     Playlist::Playlist* playlist = getCustomPlaylist();
-    if(playlist){
-        Playlist::Settings* settings = playlist->getSettings();
-
-        setVolume(settings->volume);
-        // if delay interval is turned on
-        if (settings->order == Playlist::PlayOrder::ORDERED){
-            if (settings->loop_flag){
-                playlist->setPlaybackMode(QMediaPlaylist::Loop);
-
-            }else if (!settings->loop_flag){
-                playlist->setPlaybackMode(QMediaPlaylist::Sequential);
-
-            }
-        } else if (settings->order == Playlist::PlayOrder::SHUFFLE){
-            playlist->setPlaybackMode(QMediaPlaylist::Random);
-            int index = getRandomIntInRange(0,playlist->mediaCount()-1);
-            playlist->setCurrentIndex(index);
-
-        } else if (settings->order == Playlist::PlayOrder::WEIGTHED){
-            // TO DO implement weighted
-            QMediaPlayer::pause();
-
-        }
-
-        if (settings->interval_flag){
-            delay_ = getRandomIntInRange(settings->min_delay_interval,
-                                         settings->max_delay_interval);
-            delay_flag_ = true;
-            if (activated_){
-                QMediaPlayer::play();
-                qDebug() << "Playing Index: "<<playlist->currentIndex();
-                playlist->setPlaybackMode(QMediaPlaylist::CurrentItemOnce);
-            }
-        } else {
-            delay_flag_ = false;
-            delay_ = 0;
-            if (activated_){
-                QMediaPlayer::play();
-                qDebug() << "Playing Index: "<<playlist->currentIndex();
-            }
-        }
+    if(!playlist || playlist->mediaCount() == 0)
+        return;
+
+    Playlist::Settings* settings = playlist->getSettings();
+    engine_->setVolume(settings->volume);
+    engine_->setCrossfade(getCrossfadeFrames());
+
+    // ordered playback continues at the current index,
+    // shuffle and weighted draw the first track as well
+    int index = -1;
+    if (settings->order == Playlist::PlayOrder::ORDERED){
+        index = playlist->currentIndex();
+        if (index < 0 || index >= playlist->mediaCount())
+            index = 0;
+    } else {
+        index = nextIndex();
+    }
+
+    if (index == -1){
+        qDebug() << "NOTIFICATION: no track to play in playlist";
+        return;
+    }
+
+    if (activated_){
+        queued_index_ = index;
+        engine_->start(getPath(index));
     }
 }
 
+void CustomMediaPlayer::stop()
+{
+    engine_->stop();
+    queued_index_ = -1;
+}
+
 void CustomMediaPlayer::setPlaylist(Playlist::Playlist *playlist)
 {
-    connect(playlist, SIGNAL(currentIndexChanged(int)),
-            this, SLOT(currentMediaIndexChanged(int)) );
+    playlist_ = playlist;
 
     connect(playlist, SIGNAL(changedSettings()),
             this, SLOT(mediaSettingsChanged()) );
-
-    QMediaPlayer::setPlaylist(playlist);
-}
-
-void CustomMediaPlayer::delayIsOver()
-{
-    delay_timer_->stop();
-    play();
 }
 
 void CustomMediaPlayer::activate()
 {
     activated_ = true;
+    random_plays_ = 0;
     emit toggledPlayerActivation(true);
 }
 
@@ -98,61 +86,125 @@ void CustomMediaPlayer::setActivation(bool flag)
     emit toggledPlayerActivation(flag);
 }
 
-int CustomMediaPlayer::getRandomIntInRange(int min, int max)
+void CustomMediaPlayer::onTrackStarted()
 {
-    std::random_device rd;     // only used once to initialise (seed) engine
-    std::mt19937 rng(rd());    // random-number engine used (Mersenne-Twister in this case)
-    std::uniform_int_distribution<int> uni(min,max); // guaranteed unbiased
-    return uni(rng);
+    current_index_ = queued_index_;
+    queued_index_ = -1;
+
+    if (current_index_ >= 0 && current_index_ < playlist_->mediaCount())
+        playlist_->setCurrentIndex(current_index_);
+    qDebug() << "Playing Index: " << current_index_;
+
+    if (activated_)
+        queueNext();
 }
 
-void CustomMediaPlayer::currentMediaIndexChanged(int position)
+void CustomMediaPlayer::onFinished()
 {
-    current_content_index_ = position;
-    if (activated_ && delay_flag_){
-        delay_timer_->start(delay_*1000);
-    }
+    // release audio output, until played again
+    engine_->stop();
 }
 
-void CustomMediaPlayer::mediaSettingsChanged()
+int CustomMediaPlayer::getRandomIntInRange(const QString &kind, int min, int max)
 {
-    Playlist::Settings* settings = getCustomPlaylist()->getSettings();
-    setVolume(settings->volume);
-    if (settings->interval_flag){
-        delay_flag_ = true;
-        delay_ = getRandomIntInRange(settings->min_delay_interval,
-                                     settings->max_delay_interval);
-    } else {
-        delay_flag_ = false;
-        delay_ = 0;
-    }
+    // one stream per playlist and kind, see Misc::RandomService
+    QString stream = kind;
+    if (getCustomPlaylist())
+        stream = getCustomPlaylist()->getRandomStream() + "/" + kind;
+
+    return Misc::RandomService::instance()->getInt(stream, min, max);
+}
+
+int CustomMediaPlayer::nextIndex()
+{
+    Playlist::Settings* settings = playlist_->getSettings();
+    int count = playlist_->mediaCount();
+    if (count == 0)
+        return -1;
 
     if (settings->order == Playlist::PlayOrder::ORDERED){
+        int index = current_index_ + 1;
+        if (index >= count)
+            index = settings->loop_flag ? 0 : -1;
+        return index;
+    }
+
+    // without loop, one round plays as many tracks as the playlist holds
+    if (!settings->loop_flag && random_plays_ >= count)
+        return -1;
 
-    } else if (settings->order == Playlist::PlayOrder::SHUFFLE){
-        getCustomPlaylist()->setPlaybackMode(QMediaPlaylist::Random);
+    int index = -1;
+    if (settings->order == Playlist::PlayOrder::SHUFFLE){
+        index = getRandomIntInRange("shuffle", 0, count-1);
     } else if (settings->order == Playlist::PlayOrder::WEIGTHED){
-        qDebug() << "weigthed not implemented yet";
+        index = playlist_->nextWeightedIndex();
+    }
+
+    if (index != -1)
+        ++random_plays_;
+    return index;
+}
+
+void CustomMediaPlayer::queueNext()
+{
+    int index = nextIndex();
+    if (index == -1)
+        return;
+
+    queued_index_ = index;
+    engine_->queue(getPath(index), getDelayFrames());
+}
+
+QString CustomMediaPlayer::getPath(int index) const
+{
+    return playlist_->getLocalFile(index);
+}
+
+int CustomMediaPlayer::getDelayFrames()
+{
+    Playlist::Settings* settings = playlist_->getSettings();
+    if (!settings->interval_flag)
+        return 0;
+
+    int delay = getRandomIntInRange("delay", settings->min_delay_interval,
+                                    settings->max_delay_interval);
+    return delay * AUDIO_SAMPLE_RATE;
+}
+
+int CustomMediaPlayer::getCrossfadeFrames() const
+{
+    Playlist::Settings* settings = playlist_->getSettings();
+    if (!settings->crossfade_flag)
+        return 0;
+
+    return (int) ((qint64) settings->crossfade_duration * AUDIO_SAMPLE_RATE / 1000);
+}
+
+void CustomMediaPlayer::mediaSettingsChanged()
+{
+    Playlist::Settings* settings = getCustomPlaylist()->getSettings();
+    engine_->setVolume(settings->volume);
+    engine_->setCrossfade(getCrossfadeFrames());
+
+    // queued track was drawn with previous order, loop and interval settings
+    if (engine_->isActive() && !engine_->isFading() && activated_ && queued_index_ != -1){
+        if (settings->order != Playlist::PlayOrder::ORDERED && random_plays_ > 0)
+            --random_plays_;
+        engine_->clearQueue();
+        queued_index_ = -1;
+        queueNext();
     }
 }
 
 void CustomMediaPlayer::mediaVolumeChanged(int val)
 {
-    qDebug() << val;
     if (val >= 0 && val <= 100){
-        setVolume(val);
+        engine_->setVolume(val);
     }
 }
 
 
 Playlist::Playlist *CustomMediaPlayer::getCustomPlaylist() const
 {
-
-    Playlist::Playlist* pl = qobject_cast<Playlist::Playlist*>( playlist() );
-    if(pl){
-        return pl;
-    } else {
-        return nullptr;
-    }
+    return playlist_;
 }
-
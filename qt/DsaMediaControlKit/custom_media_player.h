@@ -1,18 +1,23 @@
 #ifndef CUSTOM_MEDIA_PLAYER_H
 #define CUSTOM_MEDIA_PLAYER_H
 
-#include <QMediaPlayer>
-#include <QTimer>
+#include <QObject>
 
+#include "audio/playback_engine.h"
 #include "playlist/playlist.h"
 #include "playlist/settings.h"
 
-class CustomMediaPlayer : public QMediaPlayer
+/*
+ * Plays a Playlist::Playlist following its settings.
+ * The track following the current one is drawn when the current one starts
+ * and queued in the playback engine, so transitions (including delay intervals
+ * and crossfades) are sample accurate.
+*/
+class CustomMediaPlayer : public QObject
 {
     Q_OBJECT
 public:
     CustomMediaPlayer(QObject* parent = 0);
-    //explicit CustomMediaPlayer(QObject* parent = 0, Flags* flags = 0);
 
     Playlist::Playlist *getCustomPlaylist() const;
 
@@ -21,25 +26,50 @@ signals:
 
 public slots:
     void play();
+    void stop();
     void setPlaylist(Playlist::Playlist* playlist);
-    void currentMediaIndexChanged(int position);
     void mediaSettingsChanged();
     void mediaVolumeChanged(int val);
-    void delayIsOver();
 
     void activate();
     void deactivate();
     void setActivation(bool flag);
 
+private slots:
+    /* queues the track following the one which started */
+    void onTrackStarted();
+
+    /* last track ended, nothing queued */
+    void onFinished();
 
 private:
-    int getRandomIntInRange(int min, int max);
+    /* draws from the random stream of given kind of the playlist */
+    int getRandomIntInRange(QString const& kind, int min, int max);
+
+    /*
+     * Returns index of the track following the current one.
+     * Returns -1 if playback ends after current track.
+    */
+    int nextIndex();
+
+    /* queues track following the current one */
+    void queueNext();
+
+    /* returns local file of media at index */
+    QString getPath(int index) const;
+
+    /* draws delay before next track in frames, 0 if intervals are off */
+    int getDelayFrames();
+
+    /* crossfade length of settings in frames, 0 if crossfade is off */
+    int getCrossfadeFrames() const;
 
+    Audio::PlaybackEngine* engine_;
+    Playlist::Playlist* playlist_;
     bool activated_;
-    int current_content_index_;
-    bool delay_flag_;
-    int delay_;
-    QTimer* delay_timer_;
+    int current_index_;
+    int queued_index_;
+    int random_plays_;
 };
 
 #endif // CUSTOM_MEDIA_PLAYER_H
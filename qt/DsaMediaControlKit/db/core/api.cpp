@@ -1,11 +1,18 @@
 #include "api.h"
 
+#include <QDebug>
+#include <QRegExp>
+
+// name of the FTS5 table indexing sound_file names, paths and categories
+#define SEARCH_TABLE QString("sound_file_search")
+
 namespace DB {
 namespace Core {
 
 Api::Api(QString const& db_path, QObject *parent)
     : QObject(parent)
     , db_wrapper_(0)
+    , search_index_(false)
 {
     initDB(db_path);
 }
@@ -30,58 +37,189 @@ QSqlRelationalTableModel *Api::getResourceDirTable()
     return db_wrapper_->getTable(RESOURCE_DIRECTORY);
 }
 
-void Api::insertSoundFile(const QFileInfo &info, ResourceDirRecord const& resource_dir)
+int Api::insertSoundFile(const QFileInfo &info, ResourceDirRecord const& resource_dir)
 {
     QString rel_path = info.filePath();
     rel_path.remove(0, resource_dir.path.size());
 
-    QString value_block  = "";
-    value_block = "(name, path, relative_path) VALUES (";
-    value_block += "'" + SqliteWrapper::escape(info.fileName()) + "','";
-    value_block += SqliteWrapper::escape(info.filePath()) + "','";
-    value_block += SqliteWrapper::escape(rel_path) + "')";
+    QStringList columns;
+    columns << "name" << "path" << "relative_path";
+
+    QVariantList values;
+    values << info.fileName() << info.filePath() << rel_path;
 
-    db_wrapper_->insertQuery(SOUND_FILE, value_block);
+    int id = db_wrapper_->insertQuery(SOUND_FILE, columns, values);
+    if(id != -1 && search_index_) {
+        db_wrapper_->preparedQuery(
+            "INSERT INTO " + SEARCH_TABLE + "(rowid, name, relative_path, categories) VALUES (?,?,?,'')",
+            QVariantList() << id << info.fileName() << rel_path
+        );
+    }
+
+    return id;
 }
 
-void Api::insertCategory(const QString &name, int parent_id)
+int Api::insertCategory(const QString &name, int parent_id)
 {
-    QString value_block  = "";
+    QStringList columns;
+    QVariantList values;
+
+    columns << "name";
+    values << name;
     if(parent_id != -1) {
-        value_block = "(name, parent_id) VALUES (";
-        value_block += "'" + SqliteWrapper::escape(name) + "'," + QString::number(parent_id) + ")";
+        columns << "parent_id";
+        values << parent_id;
     }
-    else {
-        value_block = "(name) VALUES ('" + SqliteWrapper::escape(name) + "')";
-    }
-    db_wrapper_->insertQuery(CATEGORY, value_block);
+
+    return db_wrapper_->insertQuery(CATEGORY, columns, values);
+}
+
+int Api::insertSoundFileCategory(int sound_file_id, int category_id)
+{
+    QStringList columns;
+    columns << "sound_file_id" << "category_id";
+
+    QVariantList values;
+    values << sound_file_id << category_id;
+
+    int id = db_wrapper_->insertQuery(SOUND_FILE_CATEGORY, columns, values);
+    if(id != -1)
+        updateSearchCategories("rowid = ?", QVariantList() << sound_file_id);
+
+    return id;
+}
+
+int Api::insertResourceDir(const QFileInfo &info)
+{
+    QStringList columns;
+    columns << "name" << "path";
+
+    QVariantList values;
+    values << info.fileName() << info.filePath();
+
+    return db_wrapper_->insertQuery(RESOURCE_DIRECTORY, columns, values);
+}
+
+void Api::deleteSoundFile(int id)
+{
+    db_wrapper_->deleteQuery(SOUND_FILE_CATEGORY, "sound_file_id = ?", QVariantList() << id);
+    db_wrapper_->deleteQuery(SOUND_FILE, "id = ?", QVariantList() << id);
+    if(search_index_)
+        db_wrapper_->preparedQuery("DELETE FROM " + SEARCH_TABLE + " WHERE rowid = ?", QVariantList() << id);
 }
 
-void Api::insertSoundFileCategory(int sound_file_id, int category_id)
+void Api::deleteResourceDir(int id)
 {
-    QString value_block  = "";
-    value_block = "(sound_file_id, category_id) VALUES (";
-    value_block += QString::number(sound_file_id) + ",";
-    value_block += QString::number(category_id) + ")";
+    db_wrapper_->deleteQuery(RESOURCE_DIRECTORY, "id = ?", QVariantList() << id);
+}
+
+bool Api::updateSoundFileWeight(int id, double weight)
+{
+    QStringList columns;
+    columns << "weight";
+
+    QVariantList values;
+    values << weight;
+
+    return db_wrapper_->updateQuery(SOUND_FILE, columns, values, "id = ?", QVariantList() << id);
+}
+
+bool Api::updateCategoryName(int id, const QString &name)
+{
+    QStringList columns;
+    columns << "name";
+
+    QVariantList values;
+    values << name;
+
+    if(!db_wrapper_->updateQuery(CATEGORY, columns, values, "id = ?", QVariantList() << id))
+        return false;
+
+    // reindex all sound files of renamed category subtree
+    QString WHERE = "rowid IN (SELECT sound_file_id FROM sound_file_category WHERE category_id IN (";
+    WHERE += "WITH RECURSIVE subtree(id) AS (SELECT ?";
+    WHERE += " UNION SELECT category.id FROM category JOIN subtree ON category.parent_id = subtree.id) ";
+    WHERE += "SELECT id FROM subtree))";
+    updateSearchCategories(WHERE, QVariantList() << id);
 
-    db_wrapper_->insertQuery(SOUND_FILE_CATEGORY, value_block);
+    return true;
 }
 
-void Api::insertResourceDir(const QFileInfo &info)
+const QList<QSqlRecord> Api::getSoundFiles()
 {
-    QString value_block  = "";
-    value_block = "(name, path) VALUES (";
-    value_block += "'" + SqliteWrapper::escape(info.fileName()) + "','";
-    value_block += SqliteWrapper::escape(info.filePath()) + "')";
+    return db_wrapper_->preparedQuery("SELECT id, name, path, relative_path, weight FROM sound_file ORDER BY id");
+}
+
+const QList<QSqlRecord> Api::getSoundFilesByCategorySubtree(int category_id)
+{
+    QVariantList values;
+    QString seed = "SELECT id FROM category WHERE parent_id IS NULL";
+    if(category_id != -1) {
+        seed = "SELECT id FROM category WHERE id = ?";
+        values << category_id;
+    }
+
+    QString qry_str = "WITH RECURSIVE subtree(id) AS (" + seed;
+    qry_str += " UNION SELECT category.id FROM category JOIN subtree ON category.parent_id = subtree.id) ";
+    qry_str += "SELECT DISTINCT sound_file.id, sound_file.name, sound_file.path, sound_file.relative_path, sound_file.weight ";
+    qry_str += "FROM sound_file JOIN sound_file_category ON sound_file_category.sound_file_id = sound_file.id ";
+    qry_str += "WHERE sound_file_category.category_id IN subtree ORDER BY sound_file.id";
+
+    return db_wrapper_->preparedQuery(qry_str, values);
+}
+
+const QList<QSqlRecord> Api::searchSoundFiles(const QString &text, int limit)
+{
+    // split into words the way the unicode61 tokenizer does
+    QStringList words = text.split(QRegExp("[^\\w]+"), QString::SkipEmptyParts);
+    if(words.size() == 0 || limit <= 0)
+        return QList<QSqlRecord>();
+
+    if(!search_index_) {
+        QStringList conditions;
+        QVariantList values;
+        foreach(QString const& word, words) {
+            conditions.append("(name LIKE ? OR relative_path LIKE ?)");
+            values << "%" + word + "%" << "%" + word + "%";
+        }
+        values << limit;
+
+        return db_wrapper_->selectQuery("id, name, path, relative_path, weight", SOUND_FILE,
+                                        conditions.join(" AND ") + " ORDER BY name LIMIT ?", values);
+    }
+
+    // each word is matched as quoted prefix token
+    QStringList tokens;
+    foreach(QString const& word, words)
+        tokens.append("\"" + word + "\"*");
 
-    db_wrapper_->insertQuery(RESOURCE_DIRECTORY, value_block);
+    // rank name matches above category and path matches
+    QString qry_str = "SELECT sound_file.id, sound_file.name, sound_file.path, sound_file.relative_path, sound_file.weight ";
+    qry_str += "FROM " + SEARCH_TABLE + " JOIN sound_file ON sound_file.id = " + SEARCH_TABLE + ".rowid ";
+    qry_str += "WHERE " + SEARCH_TABLE + " MATCH ? ";
+    qry_str += "ORDER BY bm25(" + SEARCH_TABLE + ", 10.0, 2.0, 5.0) LIMIT ?";
+
+    return db_wrapper_->preparedQuery(qry_str, QVariantList() << tokens.join(" ") << limit);
+}
+
+void Api::rebuildSearchIndex()
+{
+    if(!search_index_)
+        return;
+
+    db_wrapper_->transaction();
+    db_wrapper_->execQuery("DELETE FROM " + SEARCH_TABLE);
+    db_wrapper_->execQuery(
+        "INSERT INTO " + SEARCH_TABLE + "(rowid, name, relative_path, categories) "
+        "SELECT id, name, relative_path, '' FROM sound_file"
+    );
+    updateSearchCategories("rowid IN (SELECT sound_file_id FROM sound_file_category)", QVariantList());
+    db_wrapper_->commit();
 }
 
 int Api::getSoundFileId(const QString &path)
 {
-    QString SELECT = "id";
-    QString WHERE = "path = '" + SqliteWrapper::escape(path) + "'";
-    QList<QSqlRecord> res = db_wrapper_->selectQuery(SELECT, SOUND_FILE, WHERE);
+    QList<QSqlRecord> res = db_wrapper_->selectQuery("id", SOUND_FILE, "path = ?", QVariantList() << path);
     if(res.size() > 0)
         return res[0].value(0).toInt();
     return -1;
@@ -89,9 +227,7 @@ int Api::getSoundFileId(const QString &path)
 
 int Api::getResourceDirId(const QString &path)
 {
-    QString SELECT = "id";
-    QString WHERE = "path = '" + SqliteWrapper::escape(path) + "'";
-    QList<QSqlRecord> res = db_wrapper_->selectQuery(SELECT, RESOURCE_DIRECTORY, WHERE);
+    QList<QSqlRecord> res = db_wrapper_->selectQuery("id", RESOURCE_DIRECTORY, "path = ?", QVariantList() << path);
     if(res.size() > 0)
         return res[0].value(0).toInt();
     return -1;
@@ -99,18 +235,20 @@ int Api::getResourceDirId(const QString &path)
 
 bool Api::soundFileExists(const QString &path, const QString &name)
 {
-    QString where = "path = '" + SqliteWrapper::escape(path) + "' and ";
-    where += "name = '" + SqliteWrapper::escape(name) + "'";
+    QVariantList values;
+    values << path << name;
 
-    return db_wrapper_->selectQuery("Count(*)", SOUND_FILE, where)[0].value(0).toInt() > 0;
+    QList<QSqlRecord> res = db_wrapper_->selectQuery("Count(*)", SOUND_FILE, "path = ? and name = ?", values);
+    return res.size() > 0 && res[0].value(0).toInt() > 0;
 }
 
 bool Api::soundFileCategoryExists(int sound_file_id, int category_id)
 {
-    QString where = "sound_file_id = " + QString::number(sound_file_id) + " and ";
-    where += "category_id = " + QString::number(category_id) + "";
+    QVariantList values;
+    values << sound_file_id << category_id;
 
-    return db_wrapper_->selectQuery("Count(*)", SOUND_FILE_CATEGORY, where)[0].value(0).toInt() > 0;
+    QList<QSqlRecord> res = db_wrapper_->selectQuery("Count(*)", SOUND_FILE_CATEGORY, "sound_file_id = ? and category_id = ?", values);
+    return res.size() > 0 && res[0].value(0).toInt() > 0;
 }
 
 const QList<int> Api::getRelatedIds(TableIndex get_table, TableIndex have_table, int have_id)
@@ -125,9 +263,9 @@ const QList<int> Api::getRelatedIds(TableIndex get_table, TableIndex have_table,
 
     QString SELECT = toString(get_table) + "_id";
     QString FROM = toString(relation_idx);
-    QString WHERE = toString(have_table) + "_id = " +  QString::number(have_id);
+    QString WHERE = toString(have_table) + "_id = ?";
 
-    foreach(QSqlRecord rec, db_wrapper_->selectQuery(SELECT, FROM, WHERE))
+    foreach(QSqlRecord rec, db_wrapper_->selectQuery(SELECT, FROM, WHERE, QVariantList() << have_id))
         ids.append(rec.value(0).toInt());
 
     return ids;
@@ -146,6 +284,48 @@ void Api::deleteAll()
 
     // delete resource_dirs
     db_wrapper_->deleteQuery(RESOURCE_DIRECTORY, "id > 0");
+
+    // delete search index
+    if(search_index_)
+        db_wrapper_->execQuery("DELETE FROM " + SEARCH_TABLE);
+}
+
+bool Api::beginTransaction()
+{
+    return db_wrapper_->transaction();
+}
+
+bool Api::commitTransaction()
+{
+    return db_wrapper_->commit();
+}
+
+bool Api::rollbackTransaction()
+{
+    return db_wrapper_->rollback();
+}
+
+void Api::setConnectionProfile(const ConnectionProfile &profile)
+{
+    db_wrapper_->setConnectionProfile(profile);
+}
+
+const ConnectionProfile &Api::getConnectionProfile() const
+{
+    return db_wrapper_->getConnectionProfile();
+}
+
+int Api::getSchemaVersion()
+{
+    QList<QSqlRecord> res = db_wrapper_->preparedQuery("PRAGMA user_version");
+    if(res.size() > 0)
+        return res[0].value(0).toInt();
+    return 0;
+}
+
+const StatementCacheStats &Api::getStatementCacheStats() const
+{
+    return db_wrapper_->getStatementCacheStats();
 }
 
 TableIndex Api::getRelationTable(TableIndex first, TableIndex second)
@@ -164,6 +344,110 @@ TableIndex Api::getRelationTable(TableIndex first, TableIndex second)
 void Api::initDB(const QString& db_path)
 {
     db_wrapper_ = new SqliteWrapper(db_path, this);
+    migrateSchema();
+    initSearchIndex();
+}
+
+void Api::migrateSchema()
+{
+    QList<QStringList> const migrations = getSchemaMigrations();
+    int version = getSchemaVersion();
+
+    while(version < migrations.size()) {
+        db_wrapper_->transaction();
+
+        bool success = true;
+        foreach(QString const& qry_str, migrations[version]) {
+            success = db_wrapper_->execQuery(qry_str);
+            if(!success)
+                break;
+        }
+
+        // user_version does not take bound values
+        if(success)
+            success = db_wrapper_->execQuery("PRAGMA user_version = " + QString::number(version + 1));
+
+        if(!success) {
+            db_wrapper_->rollback();
+            qDebug() << "FAILURE: could not migrate database schema";
+            qDebug() << " > from version:" << version;
+            return;
+        }
+
+        db_wrapper_->commit();
+        ++version;
+        qDebug() << "NOTIFICATION: migrated database schema to version" << version;
+    }
+}
+
+const QList<QStringList> Api::getSchemaMigrations()
+{
+    QList<QStringList> migrations;
+
+    // 0 -> 1: indexes for relative path lookups, category subtree walks
+    // and sound files by category (covering, so subtree queries never scan sound_file).
+    // lookups by sound_file_id are served by the unique constraint already.
+    migrations.append(QStringList()
+        << "CREATE INDEX IF NOT EXISTS sound_file_relative_path_idx ON sound_file(relative_path)"
+        << "CREATE INDEX IF NOT EXISTS category_parent_id_idx ON category(parent_id)"
+        << "CREATE INDEX IF NOT EXISTS sound_file_category_category_id_idx ON sound_file_category(category_id, sound_file_id)"
+        << "ANALYZE"
+    );
+
+    // 1 -> 2: playback weight per sound file
+    migrations.append(QStringList()
+        << "ALTER TABLE sound_file ADD COLUMN weight real NOT NULL DEFAULT 1.0"
+    );
+
+    // 2 -> 3: full-text search index over sound file names, paths and categories,
+    // prefix indexes keep search-as-you-type queries on short prefixes fast.
+    // fails if sqlite lacks FTS5 support, db then stays at version 2.
+    // rows are filled by initSearchIndex().
+    migrations.append(QStringList()
+        << "CREATE VIRTUAL TABLE IF NOT EXISTS sound_file_search USING fts5("
+           "name, relative_path, categories, "
+           "tokenize = 'unicode61 remove_diacritics 2', prefix = '2 3')"
+    );
+
+    return migrations;
+}
+
+void Api::initSearchIndex()
+{
+    // table is created by schema migration 2 -> 3,
+    // reading it also fails if it exists but sqlite lacks FTS5 support
+    QList<QSqlRecord> res = db_wrapper_->preparedQuery(
+        "SELECT (SELECT Count(*) FROM sound_file), (SELECT Count(*) FROM " + SEARCH_TABLE + ")"
+    );
+    if(res.size() == 0) {
+        qDebug() << "NOTIFICATION: full-text search not available, falling back to LIKE matching";
+        return;
+    }
+
+    search_index_ = true;
+
+    // fill if created just now, or rebuild if sound files changed without index
+    if(res[0].value(0).toInt() != res[0].value(1).toInt())
+        rebuildSearchIndex();
+}
+
+void Api::updateSearchCategories(const QString &WHERE, const QVariantList &values)
+{
+    if(!search_index_)
+        return;
+
+    // names of all related categories and their parent categories
+    QString qry_str = "UPDATE " + SEARCH_TABLE + " SET categories = (";
+    qry_str += "WITH RECURSIVE related(id, name, parent_id) AS (";
+    qry_str += "SELECT category.id, category.name, category.parent_id FROM category ";
+    qry_str += "JOIN sound_file_category ON sound_file_category.category_id = category.id ";
+    qry_str += "WHERE sound_file_category.sound_file_id = " + SEARCH_TABLE + ".rowid";
+    qry_str += " UNION SELECT category.id, category.name, category.parent_id FROM category ";
+    qry_str += "JOIN related ON category.id = related.parent_id) ";
+    qry_str += "SELECT ifnull(group_concat(name, ' '), '') FROM related) ";
+    qry_str += "WHERE " + WHERE;
+
+    db_wrapper_->preparedQuery(qry_str, values);
 }
 
 } // namespace Core
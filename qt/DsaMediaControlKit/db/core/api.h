@@ -26,10 +26,56 @@ public:
     QSqlRelationalTableModel* getSoundFileCategoryTable();
     QSqlRelationalTableModel* getResourceDirTable();
 
-    void insertSoundFile(QFileInfo const& info, ResourceDirRecord const& resource_dir);
-    void insertCategory(QString const& name, int parent_id = -1);
-    void insertSoundFileCategory(int sound_file_id, int category_id);
-    void insertResourceDir(QFileInfo const& info);
+    /*
+     * Insert functions return the id of the created row.
+     * Returns -1 if insert failed.
+    */
+    int insertSoundFile(QFileInfo const& info, ResourceDirRecord const& resource_dir);
+    int insertCategory(QString const& name, int parent_id = -1);
+    int insertSoundFileCategory(int sound_file_id, int category_id);
+    int insertResourceDir(QFileInfo const& info);
+
+    /* Deletes SoundFile and all its category relations. */
+    void deleteSoundFile(int id);
+
+    /* Deletes ResourceDir referenced by id. */
+    void deleteResourceDir(int id);
+
+    /* Sets playback weight of SoundFile referenced by id. */
+    bool updateSoundFileWeight(int id, double weight);
+
+    /* Renames category referenced by id. */
+    bool updateCategoryName(int id, QString const& name);
+
+    /*
+     * Gets all sound_file rows ordered by id.
+     * Records contain the columns id, name, path, relative_path, weight.
+    **/
+    QList<QSqlRecord> const getSoundFiles();
+
+    /*
+     * Gets all sound_file rows related to the category referenced by id
+     * or to any of its descendant categories, ordered by id.
+     * id -1 refers to all root categories (and thus to all categories).
+     * Records contain the columns id, name, path, relative_path, weight.
+    **/
+    QList<QSqlRecord> const getSoundFilesByCategorySubtree(int category_id);
+
+    /*
+     * Gets up to limit sound_file rows matching given search text,
+     * ranked by relevance (best match first).
+     * Every word in text is matched as prefix against name,
+     * relative_path and the names of all related categories (incl. parents),
+     * so partially typed words already match.
+     * Records contain the columns id, name, path, relative_path, weight.
+    **/
+    QList<QSqlRecord> const searchSoundFiles(QString const& text, int limit);
+
+    /*
+     * Rebuilds full-text search index from sound_file and category tables.
+     * Called on startup, if index is missing or out of sync.
+    */
+    void rebuildSearchIndex();
 
     int getSoundFileId(QString const& path);
     int getResourceDirId(QString const& path);
@@ -49,6 +95,28 @@ public:
     */
     void deleteAll();
 
+    /*
+     * Groups all following inserts into one transaction,
+     * until commitTransaction() or rollbackTransaction() is called.
+     * Use for bulk operations, to avoid one disk sync per row.
+    */
+    bool beginTransaction();
+    bool commitTransaction();
+    bool rollbackTransaction();
+
+    /*
+     * Sets pragma settings of the db connection.
+     * See ConnectionProfile for predefined profiles.
+    */
+    void setConnectionProfile(ConnectionProfile const& profile);
+    ConnectionProfile const& getConnectionProfile() const;
+
+    /* Returns schema version of the opened db (sqlite user_version). */
+    int getSchemaVersion();
+
+    /* Returns hit/miss counters and prepare time of the statement cache. */
+    StatementCacheStats const& getStatementCacheStats() const;
+
 signals:
 
 public slots:
@@ -62,7 +130,35 @@ private:
 
     void initDB(QString const&);
 
+    /*
+     * Upgrades schema of opened db to latest version,
+     * by applying all migrations newer than its user_version.
+     * Each migration runs in its own transaction.
+    */
+    void migrateSchema();
+
+    /*
+     * Gets statements of all schema migrations.
+     * Migration at index i upgrades schema version i to i+1.
+     * Only append new migrations, never change existing ones.
+    */
+    static QList<QStringList> const getSchemaMigrations();
+
+    /*
+     * Enables the full-text search index created by schema migration 2 -> 3
+     * and fills it, if it is out of sync with the sound_file table.
+     * Falls back to LIKE matching if sqlite lacks FTS5 support.
+    */
+    void initSearchIndex();
+
+    /*
+     * Recomputes indexed category names of all search index rows matching WHERE,
+     * with values bound to its placeholders.
+    */
+    void updateSearchCategories(QString const& WHERE, QVariantList const& values);
+
     SqliteWrapper* db_wrapper_;
+    bool search_index_;
 };
 
 } // namespace Core
@@ -6,16 +6,27 @@
 #include <QElapsedTimer>
 #include <QCoreApplication>
 
+// number of prepared statements kept at most
+#define STATEMENT_CACHE_SIZE 64
+
 namespace DB {
 namespace Core {
 
 SqliteWrapper::SqliteWrapper(QString const& db_path, QObject* parent):
     QObject(parent)
   , db_()
+  , statements_()
+  , stats_()
+  , profile_()
 {
     initDB(db_path);
 }
 
+SqliteWrapper::~SqliteWrapper()
+{
+    clearStatementCache();
+}
+
 QSqlRelationalTableModel* SqliteWrapper::getTable(TableIndex index)
 {
     if(!db_.isOpen() || index == NONE) {
@@ -64,6 +75,57 @@ const QList<QSqlRecord> SqliteWrapper::selectQuery(const QString &SELECT, TableI
     return selectQuery(SELECT, toString(FROM), WHERE);
 }
 
+const QList<QSqlRecord> SqliteWrapper::selectQuery(const QString &SELECT, const QString &FROM,
+                                                   const QString &WHERE, const QVariantList &values)
+{
+    QList<QSqlRecord> results;
+    if(SELECT.size() == 0 || FROM.size() == 0) {
+        qDebug() << "FAILURE: parameter in selectQuery() missing";
+        qDebug() << " > SELECT:" << SELECT;
+        qDebug() << " > FROM:" << FROM;
+        qDebug() << " > WHERE:" << WHERE;
+        return results;
+    }
+
+    QString qry_str = "SELECT " + SELECT + " FROM " + FROM;
+    if(WHERE.size() > 0)
+        qry_str += " WHERE " + WHERE;
+
+    executeQuery(qry_str, values, &results);
+    return results;
+}
+
+const QList<QSqlRecord> SqliteWrapper::selectQuery(const QString &SELECT, TableIndex FROM,
+                                                   const QString &WHERE, const QVariantList &values)
+{
+    return selectQuery(SELECT, toString(FROM), WHERE, values);
+}
+
+const QList<QSqlRecord> SqliteWrapper::preparedQuery(const QString &qry_str, const QVariantList &values)
+{
+    QList<QSqlRecord> results;
+    executeQuery(qry_str, values, &results);
+    return results;
+}
+
+bool SqliteWrapper::execQuery(const QString &qry_str)
+{
+    if(!db_.isOpen()) {
+        qDebug() << "FAILURE: Database not open";
+        return false;
+    }
+
+    QSqlQuery qry(db_);
+    if(!qry.exec(qry_str)) {
+        qDebug() << "FAILURE: SQL Query failed to execute.";
+        qDebug() << " > Query:" << qry_str;
+        qDebug() << " > Error:" << qry.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
 void SqliteWrapper::insertQuery(TableIndex index, const QString &value_block)
 {
     if(index == NONE)
@@ -74,12 +136,80 @@ void SqliteWrapper::insertQuery(TableIndex index, const QString &value_block)
     executeQuery(qry_str);
 }
 
+int SqliteWrapper::insertQuery(TableIndex index, const QStringList &columns, const QVariantList &values)
+{
+    if(index == NONE || columns.size() == 0 || columns.size() != values.size()) {
+        qDebug() << "FAILURE: invalid parameters in insertQuery()";
+        qDebug() << " > columns:" << columns;
+        return -1;
+    }
+
+    if(!db_.isOpen()) {
+        qDebug() << "FAILURE: Database not open";
+        return -1;
+    }
+
+    QStringList placeholders;
+    for(int i = 0; i < columns.size(); ++i)
+        placeholders.append("?");
+
+    QString qry_str = "INSERT INTO " + toString(index);
+    qry_str += " (" + columns.join(",") + ") VALUES (" + placeholders.join(",") + ")";
+
+    QSqlQuery* qry = executeQuery(qry_str, values);
+    if(qry == 0)
+        return -1;
+
+    QVariant id = qry->lastInsertId();
+    if(!id.isValid())
+        return -1;
+
+    return id.toInt();
+}
+
+bool SqliteWrapper::updateQuery(TableIndex index, const QStringList &columns, const QVariantList &values,
+                                const QString &WHERE, const QVariantList &where_values)
+{
+    if(index == NONE || columns.size() == 0 || columns.size() != values.size() || WHERE.size() == 0) {
+        qDebug() << "FAILURE: invalid parameters in updateQuery()";
+        qDebug() << " > columns:" << columns;
+        qDebug() << " > WHERE:" << WHERE;
+        return false;
+    }
+
+    if(!db_.isOpen()) {
+        qDebug() << "FAILURE: Database not open";
+        return false;
+    }
+
+    QStringList assignments;
+    foreach(QString const& column, columns)
+        assignments.append(column + " = ?");
+
+    QString qry_str = "UPDATE " + toString(index) + " SET " + assignments.join(",");
+    qry_str += " WHERE " + WHERE;
+
+    return executeQuery(qry_str, values + where_values) != 0;
+}
+
 void SqliteWrapper::deleteQuery(TableIndex index, const QString &WHERE)
 {
     QString qry = "DELETE FROM " + toString(index) + " WHERE " + WHERE;
     executeQuery(qry);
 }
 
+bool SqliteWrapper::deleteQuery(TableIndex index, const QString &WHERE, const QVariantList &values)
+{
+    if(index == NONE || WHERE.size() == 0) {
+        qDebug() << "FAILURE: invalid parameters in deleteQuery()";
+        qDebug() << " > WHERE:" << WHERE;
+        return false;
+    }
+
+    QString qry_str = "DELETE FROM " + toString(index) + " WHERE " + WHERE;
+    return executeQuery(qry_str, values) != 0;
+}
+
 void SqliteWrapper::open()
 {
     if(db_.isOpen()) {
@@ -89,6 +219,7 @@ void SqliteWrapper::open()
 
     if(db_.open()) {
         qDebug() << "SUCCESS: connected to database";
+        applyConnectionProfile();
     }
     else {
         qDebug() << "FAILURE: could not open database";
@@ -98,6 +229,7 @@ void SqliteWrapper::open()
 void SqliteWrapper::close()
 {
     if(db_.isOpen()) {
+        clearStatementCache();
         db_.close();
     }
     else {
@@ -105,6 +237,51 @@ void SqliteWrapper::close()
     }
 }
 
+void SqliteWrapper::setConnectionProfile(const ConnectionProfile &profile)
+{
+    profile_ = profile;
+    if(db_.isOpen())
+        applyConnectionProfile();
+}
+
+const ConnectionProfile &SqliteWrapper::getConnectionProfile() const
+{
+    return profile_;
+}
+
+bool SqliteWrapper::transaction()
+{
+    if(!db_.transaction()) {
+        qDebug() << "FAILURE: could not start transaction";
+        qDebug() << " > Error:" << db_.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+bool SqliteWrapper::commit()
+{
+    if(!db_.commit()) {
+        qDebug() << "FAILURE: could not commit transaction";
+        qDebug() << " > Error:" << db_.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+bool SqliteWrapper::rollback()
+{
+    if(!db_.rollback()) {
+        qDebug() << "FAILURE: could not rollback transaction";
+        qDebug() << " > Error:" << db_.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
 const QString SqliteWrapper::escape(const QString &str)
 {
     QString temp(str);
@@ -112,6 +289,11 @@ const QString SqliteWrapper::escape(const QString &str)
     return temp;
 }
 
+const StatementCacheStats &SqliteWrapper::getStatementCacheStats() const
+{
+    return stats_;
+}
+
 void SqliteWrapper::initDB(QString const& db_path)
 {
     db_ = QSqlDatabase::addDatabase("QSQLITE");
@@ -120,6 +302,23 @@ void SqliteWrapper::initDB(QString const& db_path)
     open();
 }
 
+void SqliteWrapper::applyConnectionProfile()
+{
+    // pragmas do not take bound values
+    QStringList pragmas;
+    pragmas << "PRAGMA journal_mode = " + profile_.journal_mode;
+    pragmas << "PRAGMA synchronous = " + profile_.synchronous;
+    pragmas << "PRAGMA cache_size = " + QString::number(profile_.cache_size);
+    pragmas << "PRAGMA mmap_size = " + QString::number(profile_.mmap_size);
+    pragmas << "PRAGMA temp_store = " + profile_.temp_store;
+    pragmas << "PRAGMA foreign_keys = " + QString(profile_.foreign_keys ? "ON" : "OFF");
+
+    foreach(QString const& pragma, pragmas)
+        execQuery(pragma);
+
+    qDebug() << "NOTIFICATION: applied connection profile" << profile_.name;
+}
+
 const QList<QSqlRecord> SqliteWrapper::executeQuery(const QString & qry_str)
 {
     QList<QSqlRecord> results;
@@ -157,5 +356,79 @@ const QList<QSqlRecord> SqliteWrapper::executeQuery(const QString & qry_str)
     return results;
 }
 
+QSqlQuery* SqliteWrapper::executeQuery(const QString &qry_str, const QVariantList &values, QList<QSqlRecord>* results)
+{
+    if(!db_.isOpen()) {
+        qDebug() << "FAILURE: Database not open";
+        return 0;
+    }
+
+    QSqlQuery* qry = getPreparedQuery(qry_str);
+    if(qry == 0)
+        return 0;
+
+    for(int i = 0; i < values.size(); ++i)
+        qry->bindValue(i, values[i]);
+
+    if(!qry->exec()) {
+        qDebug() << "FAILURE: SQL Query failed to execute.";
+        qDebug() << " > Query:" << qry_str;
+        qDebug() << " > Error:" << qry->lastError().text();
+        return 0;
+    }
+
+    if(results != 0) {
+        while(qry->next())
+            results->append(qry->record());
+    }
+
+    // release read lock held by statement, keep it prepared
+    if(qry->isSelect())
+        qry->finish();
+
+    return qry;
+}
+
+QSqlQuery* SqliteWrapper::getPreparedQuery(const QString &qry_str)
+{
+    QSqlQuery* qry = statements_.value(qry_str, 0);
+    if(qry != 0) {
+        ++stats_.hits;
+        return qry;
+    }
+
+    ++stats_.misses;
+
+    if(statements_.size() >= STATEMENT_CACHE_SIZE)
+        clearStatementCache();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    qry = new QSqlQuery(db_);
+    qry->setForwardOnly(true);
+    bool prepared = qry->prepare(qry_str);
+
+    stats_.prepare_nsecs += timer.nsecsElapsed();
+
+    if(!prepared) {
+        qDebug() << "FAILURE: SQL Query could not be prepared.";
+        qDebug() << " > Query:" << qry_str;
+        qDebug() << " > Error:" << qry->lastError().text();
+        delete qry;
+        return 0;
+    }
+
+    statements_[qry_str] = qry;
+    return qry;
+}
+
+void SqliteWrapper::clearStatementCache()
+{
+    foreach(QSqlQuery* qry, statements_)
+        delete qry;
+    statements_.clear();
+}
+
 } // namespace Core
 } // namespace DB
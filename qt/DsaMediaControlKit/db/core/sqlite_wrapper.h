@@ -5,21 +5,92 @@
 #include <QSqlDatabase>
 #include <QSqlRelationalTableModel>
 #include <QSqlRecord>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QVariant>
+#include <QHash>
 
 #include "db/table_records.h"
 
 namespace DB {
 namespace Core {
 
+/*
+ * Usage counters of the prepared statement cache.
+ * prepare_nsecs is the total time spent preparing statements.
+*/
+struct StatementCacheStats {
+    int hits;
+    int misses;
+    qint64 prepare_nsecs;
+
+    StatementCacheStats()
+        : hits(0)
+        , misses(0)
+        , prepare_nsecs(0)
+    {}
+};
+
+/*
+ * Pragma settings applied to the connection when it is opened.
+ * cache_size follows sqlite semantics (negative values are KiB),
+ * mmap_size is given in bytes (0 disables memory mapping).
+ * journal_mode can only change outside of transactions.
+*/
+struct ConnectionProfile {
+    QString name;
+    QString journal_mode;
+    QString synchronous;
+    int cache_size;
+    qint64 mmap_size;
+    QString temp_store;
+    bool foreign_keys;
+
+    ConnectionProfile()
+        : name("default")
+        , journal_mode("WAL")
+        , synchronous("NORMAL")
+        , cache_size(-16384)
+        , mmap_size(64 * 1024 * 1024)
+        , temp_store("MEMORY")
+        , foreign_keys(true)
+    {}
+
+    /* Profile used for interactive work, durable after each commit (in WAL mode). */
+    static ConnectionProfile const defaultProfile()
+    {
+        return ConnectionProfile();
+    }
+
+    /*
+     * Profile used while importing resource folders.
+     * Skips disk syncs and uses a larger cache,
+     * a crash may lose the last committed import chunks.
+    */
+    static ConnectionProfile const bulkImportProfile()
+    {
+        ConnectionProfile profile;
+        profile.name = "bulk import";
+        profile.synchronous = "OFF";
+        profile.cache_size = -65536;
+        profile.mmap_size = 256 * 1024 * 1024;
+        return profile;
+    }
+};
+
 /*
  * Class that can establish and manage connection to a Sqlite database.
  * Provides low-level access to data contained in db.
+ * Queries taking bound values are prepared once per query template
+ * and kept in a statement cache, so parser and planner only run
+ * on the first call.
 */
 class SqliteWrapper : public QObject
 {
     Q_OBJECT
 public:
     SqliteWrapper(QString const& db_path, QObject* parent = 0);
+    ~SqliteWrapper();
 
     /* Get a QSqlTableModel of a databse table identified by given TableIndex */
     QSqlRelationalTableModel* getTable(TableIndex index);
@@ -28,22 +99,111 @@ public:
     QList<QSqlRecord> const selectQuery(QString const& SELECT, QString const& FROM, QString const& WHERE = "");
     QList<QSqlRecord> const selectQuery(QString const& SELECT, TableIndex FROM, QString const& WHERE = "");
 
+    /*
+     * Perform Select query with bound values.
+     * WHERE has to contain one '?' placeholder per value.
+     * The prepared statement is cached.
+    */
+    QList<QSqlRecord> const selectQuery(QString const& SELECT, QString const& FROM,
+                                        QString const& WHERE, QVariantList const& values);
+    QList<QSqlRecord> const selectQuery(QString const& SELECT, TableIndex FROM,
+                                        QString const& WHERE, QVariantList const& values);
+
+    /*
+     * Executes given query with bound values and returns selected records.
+     * Use for statements which do not fit selectQuery (e.g. WITH clauses).
+     * The prepared statement is cached.
+    */
+    QList<QSqlRecord> const preparedQuery(QString const& qry_str, QVariantList const& values = QVariantList());
+
+    /*
+     * Executes given statement once, without caching it.
+     * Use for schema statements (e.g. CREATE TABLE).
+     * Returns success of query.
+    */
+    bool execQuery(QString const& qry_str);
+
     void insertQuery(TableIndex index, QString const& value_block);
 
+    /*
+     * Inserts one row into table referenced by index.
+     * Values are bound to the prepared statement as parameters,
+     * so no escaping is needed.
+     * Returns the rowid of the inserted row, -1 on failure.
+    */
+    int insertQuery(TableIndex index, QStringList const& columns, QVariantList const& values);
+
+    /*
+     * Updates given columns of all rows matching WHERE.
+     * Values are bound to the prepared statement as parameters,
+     * followed by where_values for the placeholders in WHERE.
+     * Returns success of query.
+    */
+    bool updateQuery(TableIndex index, QStringList const& columns, QVariantList const& values,
+                     QString const& WHERE, QVariantList const& where_values = QVariantList());
+
     void deleteQuery(TableIndex index, QString const& WHERE);
 
+    /*
+     * Deletes all rows matching WHERE, with values bound to its placeholders.
+     * Returns success of query.
+    */
+    bool deleteQuery(TableIndex index, QString const& WHERE, QVariantList const& values);
+
     void open();
     void close();
 
+    /*
+     * Sets pragma settings of the connection.
+     * Applied immediately if connection is open, and on every open().
+    */
+    void setConnectionProfile(ConnectionProfile const& profile);
+    ConnectionProfile const& getConnectionProfile() const;
+
+    /*
+     * Transaction handling for the connection.
+     * All queries executed between transaction() and commit()
+     * are written to disk at once.
+    */
+    bool transaction();
+    bool commit();
+    bool rollback();
+
     /* returns a safe version of given string as string value for sql query */
     static QString const escape(QString const& str);
 
+    /* returns usage counters of the statement cache */
+    StatementCacheStats const& getStatementCacheStats() const;
+
 private:
     void initDB(QString const&);
 
+    /* Applies pragmas of current connection profile */
+    void applyConnectionProfile();
+
     QList<QSqlRecord> const executeQuery(QString const&);
 
+    /*
+     * Executes query with given template and bound values.
+     * Selected records are appended to results, if not 0.
+     * Returns the executed query, 0 on failure.
+    */
+    QSqlQuery* executeQuery(QString const& qry_str, QVariantList const& values, QList<QSqlRecord>* results = 0);
+
+    /*
+     * Returns the cached statement for given query template.
+     * Statement gets prepared and cached on first request.
+     * Returns 0 if statement could not be prepared.
+    */
+    QSqlQuery* getPreparedQuery(QString const& qry_str);
+
+    /* deletes all cached statements */
+    void clearStatementCache();
+
     QSqlDatabase db_;
+    QHash<QString, QSqlQuery*> statements_;
+    StatementCacheStats stats_;
+    ConnectionProfile profile_;
 };
 
 } // namespace Core
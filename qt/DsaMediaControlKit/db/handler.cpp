@@ -2,21 +2,31 @@
 
 #include <QDebug>
 #include <QElapsedTimer>
-#include <QCoreApplication>
-#include <QDebug>
 
 namespace DB {
 
 Handler::Handler(DB::Core::Api* api, QObject *parent)
     : QObject(parent)
     , api_(api)
+    , interactive_profile_()
+    , bulk_import_(false)
+    , bulk_import_timer_()
+    , bulk_import_rows_(0)
     , category_tree_model_(0)
     , sound_file_table_model_(0)
     , resource_dir_table_model_(0)
 {
     if(api_ != 0) {
+        QElapsedTimer timer;
+        timer.start();
+
         getCategoryTreeModel();
         getSoundFileTableModel();
+
+        qDebug() << "NOTIFICATION: startup select finished (categories and all sound files)";
+        qDebug() << " > sound files:" << sound_file_table_model_->getSoundFiles().size();
+        qDebug() << " > profile:" << api_->getConnectionProfile().name;
+        qDebug() << " > duration (ms):" << timer.elapsed();
     }
 }
 
@@ -57,25 +67,32 @@ Model::ResourceDirTableModel *Handler::getResourceDirTableModel()
 
 const QList<SoundFileRecord *> Handler::getSoundFileRecordsByCategoryId(int category_id)
 {
-    QList<SoundFileRecord*> records;
+    QElapsedTimer timer;
+    timer.start();
 
-    QList<int> cat_ids = getCategoryTreeModel()->getSubCategoryIdsByCategoryId(category_id);
-    cat_ids.append(category_id);
+    // resolves whole category subtree in one query
+    QList<QSqlRecord> res = api_->getSoundFilesByCategorySubtree(category_id);
+    QList<SoundFileRecord*> const sound_files = getSoundFileTableModel()->getSoundFilesByDbRecords(res);
 
-    foreach(int c_id, cat_ids) {
-        foreach(int s_id, api_->getRelatedIds(SOUND_FILE, CATEGORY, c_id))
-            records.append(getSoundFileTableModel()->getSoundFileById(s_id));
-    }
+    qDebug() << "NOTIFICATION: category query finished";
+    qDebug() << " > profile:" << api_->getConnectionProfile().name;
+    qDebug() << " > sound files:" << sound_files.size() << "duration (ms):" << timer.elapsed();
+
+    return sound_files;
+}
 
-    return records;
+const QList<SoundFileRecord *> Handler::searchSoundFiles(const QString &text, int limit)
+{
+    QList<QSqlRecord> res = api_->searchSoundFiles(text, limit);
+    return getSoundFileTableModel()->getSoundFilesByDbRecords(res);
 }
 
 void Handler::deleteAll()
 {
     api_->deleteAll();
-    getCategoryTreeModel()->update();
-    getSoundFileTableModel()->update();
-    getResourceDirTableModel()->update();
+    getSoundFileTableModel()->removeAll();
+    getCategoryTreeModel()->removeAll();
+    getResourceDirTableModel()->removeAll();
 }
 
 void Handler::addSoundFile(const QFileInfo& info, const ResourceDirRecord& resource_dir)
@@ -88,8 +105,10 @@ void Handler::addCategory(QString name, CategoryRecord *parent)
     int p_id = -1;
     if(parent != 0)
         p_id = parent->id;
-    api_->insertCategory(name, p_id);
-    getCategoryTreeModel()->update();
+    int id = api_->insertCategory(name, p_id);
+    if(id == -1)
+        return;
+    getCategoryTreeModel()->addCategoryRecord(id, name, p_id);
 }
 
 void Handler::addSoundFileCategory(int sound_file_id, int category_id)
@@ -97,48 +116,42 @@ void Handler::addSoundFileCategory(int sound_file_id, int category_id)
     api_->insertSoundFileCategory(sound_file_id, category_id);
 }
 
-void Handler::insertSoundFilesAndCategories(const QList<DB::SoundFile>& sound_files)
+void Handler::insertSoundFiles(const QList<SoundFile> &sound_files)
 {
-    emit progressChanged(0);
-    QCoreApplication::processEvents();
-
-    QElapsedTimer timer;
-    timer.start();
-
-    CategoryRecord* cat = 0;
-    int i = 1;
-    foreach(SoundFile sf, sound_files) {                
-        // check if sound_file already imported
-        SoundFileRecord* sf_rec = getSoundFileTableModel()->getSoundFileByPath(sf.getFileInfo().filePath());
-        if(sf_rec != 0)
-            continue;
-
-        // insert new sound_file into DB
-        addSoundFile(sf.getFileInfo(), sf.getResourceDir());
-        sf_rec = getSoundFileTableModel()->getLastSoundFileRecord();
-
-        // insert new category into DB
-        cat = getCategoryTreeModel()->getCategoryByPath(sf.getCategoryPath());
-        if(cat == 0) {
-            addCategory(sf.getCategoryPath());
-            cat = getCategoryTreeModel()->getCategoryByPath(sf.getCategoryPath());
-        }
+    if(sound_files.size() == 0)
+        return;
 
-        // insert category sound_file relation into db
-        addSoundFileCategory(sf_rec->id, cat->id);
-
-        if(timer.elapsed() > 100) {
-            int progress = (int) (i/(float)sound_files.size() * 100);
-            emit progressChanged(progress);
-            QCoreApplication::processEvents();
-            timer.start();
-        }
+    api_->beginTransaction();
+    foreach(SoundFile const& sf, sound_files)
+        bulk_import_rows_ += importSoundFile(sf);
+    api_->commitTransaction();
+}
 
-        ++i;
+void Handler::setBulkImport(bool enabled)
+{
+    if(enabled == bulk_import_)
+        return;
+
+    bulk_import_ = enabled;
+    if(enabled) {
+        interactive_profile_ = api_->getConnectionProfile();
+        api_->setConnectionProfile(Core::ConnectionProfile::bulkImportProfile());
+        bulk_import_timer_.start();
+        bulk_import_rows_ = 0;
+    }
+    else {
+        qint64 ms = bulk_import_timer_.elapsed();
+        Core::StatementCacheStats const& stats = api_->getStatementCacheStats();
+        qDebug() << "NOTIFICATION: bulk import finished";
+        qDebug() << " > profile:" << api_->getConnectionProfile().name;
+        qDebug() << " > rows written:" << bulk_import_rows_;
+        qDebug() << " > duration (ms):" << ms;
+        if(ms > 0)
+            qDebug() << " > rows/sec:" << (int) (bulk_import_rows_ / (ms / 1000.0f));
+        qDebug() << " > statement cache hits:" << stats.hits << "misses:" << stats.misses;
+        qDebug() << " > statement prepare time (ms):" << stats.prepare_nsecs / 1000000;
+        api_->setConnectionProfile(interactive_profile_);
     }
-
-    emit progressChanged(100);
-    QCoreApplication::processEvents();
 }
 
 void Handler::addCategory(const QStringList &path)
@@ -161,5 +174,33 @@ void Handler::addCategory(const QStringList &path)
     }
 }
 
-} // namespace DB
+int Handler::importSoundFile(const SoundFile &sf)
+{
+    // check if sound_file already imported
+    if(getSoundFileTableModel()->getSoundFileByPath(sf.getFileInfo().filePath()) != 0)
+        return 0;
+
+    // insert new sound_file into DB
+    SoundFileRecord* sf_rec = getSoundFileTableModel()->addSoundFileRecord(sf.getFileInfo(), sf.getResourceDir());
+    if(sf_rec == 0)
+        return 0;
+    int rows = 1;
+
+    // insert new category into DB
+    CategoryRecord* cat = getCategoryTreeModel()->getCategoryByPath(sf.getCategoryPath());
+    if(cat == 0) {
+        addCategory(sf.getCategoryPath());
+        cat = getCategoryTreeModel()->getCategoryByPath(sf.getCategoryPath());
+        ++rows;
+    }
+    if(cat == 0)
+        return rows;
 
+    // insert category sound_file relation into db
+    if(api_->insertSoundFileCategory(sf_rec->id, cat->id) != -1)
+        ++rows;
+
+    return rows;
+}
+
+} // namespace DB
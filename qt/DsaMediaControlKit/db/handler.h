@@ -4,6 +4,7 @@
 #include <QObject>
 
 #include <QSqlRelationalTableModel>
+#include <QElapsedTimer>
 
 #include "core/api.h"
 #include "sound_file.h"
@@ -31,12 +32,25 @@ public:
 
     /*
      * Gets a list of SoundFileRecords,
-     * associated with Category referenced by given id.
+     * associated with Category referenced by given id
+     * or any of its subcategories (-1 refers to all categories).
     */
     QList<SoundFileRecord*> const getSoundFileRecordsByCategoryId(int category_id = -1);
 
+    /*
+     * Gets up to limit SoundFileRecords matching given search text,
+     * best match first. Words are matched as prefixes of
+     * name, relative path and category names, so this can be
+     * called on every keystroke of a search-as-you-type field.
+     * Returns empty list for empty text.
+    */
+    QList<SoundFileRecord*> const searchSoundFiles(QString const& text, int limit = 100);
+
 signals:
-    void progressChanged(int);
+    /*
+     * Progress of a running operation in percent.
+    */
+    void progressChanged(int progress);
 
 public slots:
     /*
@@ -60,17 +74,37 @@ public slots:
     void addSoundFileCategory(int sound_file_id, int category_id);
 
     /*
-     * Inserts new SoundFiles based on list given.
-     * Will also insert new Categories in case any SoundFile
-     * describes a new Category tree.
+     * Inserts a batch of SoundFiles (and their Categories)
+     * within a single transaction.
+     * Does not report progress, used for streamed imports.
+    */
+    void insertSoundFiles(QList<DB::SoundFile> const&);
+
+    /*
+     * Switches db connection to the bulk import profile (true)
+     * and back to the previous profile (false).
+     * Connected to ResourceImporter::importRunning(bool).
     */
-    void insertSoundFilesAndCategories(QList<DB::SoundFile> const&);
+    void setBulkImport(bool enabled);
 
 private:
     void addCategory(QStringList const& path);
 
+    /*
+     * Inserts given SoundFile, its Category tree and relation.
+     * Returns number of rows written to the DB.
+    */
+    int importSoundFile(DB::SoundFile const&);
+
     Core::Api* api_;
 
+    // profile to restore after bulk import
+    Core::ConnectionProfile interactive_profile_;
+    bool bulk_import_;
+    QElapsedTimer bulk_import_timer_;
+    // rows written since bulk import started
+    int bulk_import_rows_;
+
     Model::CategoryTreeModel* category_tree_model_;
     Model::SoundFileTableModel* sound_file_table_model_;
     Model::ResourceDirTableModel* resource_dir_table_model_;
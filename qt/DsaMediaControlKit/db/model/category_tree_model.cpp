@@ -18,8 +18,6 @@ CategoryTreeModel::CategoryTreeModel(Core::Api* api, QObject* parent)
 void CategoryTreeModel::select()
 {
     table_model_ = api_->getCategoryTable();
-    connect(table_model_, SIGNAL(rowsInserted(QModelIndex,int,int)),
-            this, SLOT(dbRowsInserted(QModelIndex,int,int)));
     connect(this, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)),
             this, SLOT(onDataChanged(QModelIndex,QModelIndex,QVector<int>)));
 
@@ -171,31 +169,75 @@ void CategoryTreeModel::update()
     emit updated();
 }
 
-void CategoryTreeModel::dbRowsInserted(QModelIndex, int, int)
+CategoryRecord* CategoryTreeModel::addCategoryRecord(int id, const QString &name, int parent_id)
 {
-    createModel();
+    if(categories_.contains(id)) {
+        qDebug() << "FAILURE: cannot add CategoryRecord.";
+        qDebug() << " > Category with id" << id << "already exists.";
+        return 0;
+    }
+
+    CategoryRecord* parent = 0;
+    QStandardItem* parent_item = invisibleRootItem();
+    if(parent_id > 0) {
+        parent = getCategoryById(parent_id);
+        parent_item = getItemByCategory(parent);
+        if(parent == 0 || parent_item == 0) {
+            qDebug() << "FAILURE: cannot add CategoryRecord.";
+            qDebug() << " > parent Category with id" << parent_id << "does not exist.";
+            return 0;
+        }
+    }
+
+    CategoryRecord* category = new CategoryRecord;
+    category->id = id;
+    category->name = name;
+    category->parent_id = parent == 0 ? 0 : parent_id;
+    category->parent = parent;
+    if(parent != 0)
+        parent->children.append(category);
+
+    categories_[id] = category;
+
+    // data is set before item is attached, so no dataChanged is emitted
+    QStandardItem* item = new QStandardItem;
+    item->setData(id, Qt::UserRole);
+    item->setData(name, Qt::DisplayRole);
+    category_to_item_[category] = item;
+
+    // emits rowsInserted for the new row only
+    parent_item->appendRow(item);
+
+    return category;
 }
 
-void CategoryTreeModel::onDataChanged(const QModelIndex &topLeft, const QModelIndex&, const QVector<int>&)
+void CategoryTreeModel::removeAll()
 {
-    QMap<QString, int> attribute_col;
-    attribute_col["id"] = -1;
-    attribute_col["name"] = -1;
-    for(int col = 0; col < table_model_->columnCount(); ++col) {
-        QString header_name = table_model_->headerData(col, Qt::Horizontal, Qt::DisplayRole).toString();
-        attribute_col[header_name] = col;
-    }
+    if(invisibleRootItem()->rowCount() > 0)
+        invisibleRootItem()->removeRows(0, invisibleRootItem()->rowCount());
 
-    QString name = topLeft.data(Qt::DisplayRole).toString();
-    int rid = topLeft.data(Qt::UserRole).toInt();
+    category_to_item_.clear();
 
-    for(int row = 0; row < table_model_->rowCount(); ++row) {
-        QModelIndex index = table_model_->index(row,attribute_col["id"]);
-        if(index.data().toInt() == rid) {
-            QModelIndex index = table_model_->index(row,attribute_col["name"]);
-            table_model_->setData(index, name);
-            table_model_->submit();
-        }
+    for(QMap<int, CategoryRecord*>::iterator it = categories_.begin(); it != categories_.end(); ++it)
+        delete it.value();
+
+    categories_.clear();
+}
+
+void CategoryTreeModel::onDataChanged(const QModelIndex &topLeft, const QModelIndex& bottomRight, const QVector<int>&)
+{
+    for(int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        QModelIndex index = topLeft.sibling(row, 0);
+        CategoryRecord* category = getCategoryByIndex(index);
+        if(category == 0)
+            continue;
+
+        QString name = index.data(Qt::DisplayRole).toString();
+        if(name == category->name)
+            continue;
+
+        if(api_->updateCategoryName(category->id, name))
+            category->name = name;
     }
 }
 
@@ -93,7 +93,18 @@ public:
     /* Gets all subcategory ids of given CategoryRecord */
     QList<int> const getSubCategoryIdsByCategoryId(int);
 
-    /* Adds a CategoryRecord to this model and  **/
+    /*
+     * Adds a CategoryRecord for an existing db row to this model.
+     * Only the item of the new CategoryRecord gets inserted (parent_id <= 0 means root).
+     * Returns the created CategoryRecord, 0 if adding failed.
+    **/
+    CategoryRecord* addCategoryRecord(int id, QString const& name, int parent_id);
+
+    /*
+     * Removes all CategoryRecords from this model, without touching the db.
+     * Use after all rows have been deleted from db.
+    **/
+    void removeAll();
 
     /*
      * Compares given Category names.
@@ -108,7 +119,6 @@ public:
 public slots:
     /* Reselects and builds the CategoryTreeModel **/
     void update();
-    void dbRowsInserted(QModelIndex,int, int);
     void onDataChanged(QModelIndex const& topLeft,
                        QModelIndex const& bottomRight,
                        QVector<int> const& roles);
@@ -112,80 +112,58 @@ bool ResourceDirTableModel::removeColumns(int, int, const QModelIndex&)
     return false;
 }
 
-bool ResourceDirTableModel::removeRow(int row, const QModelIndex&)
+bool ResourceDirTableModel::removeRow(int row, const QModelIndex& parent)
 {
-    if(row < 0)
+    return removeRows(row, 1, parent);
+}
+
+bool ResourceDirTableModel::removeRows(int row, int count, const QModelIndex&)
+{
+    if(count <= 0 || row < 0 || row + count > records_.size())
         return false;
 
-    // collect ResourceDirRecord being deleted
-    DB::ResourceDirRecord* rec = getResourceDirByRow(row);
-    if(rec != 0) {
+    // collect all ResourceDirRecords being deleted
+    QList<DB::ResourceDirRecord*> recs = records_.mid(row, count);
 
-        // signal deletion
-        emit aboutToBeDeleted(rec);
-        QCoreApplication::processEvents();
+    // signal deletion
+    if(recs.size() == 1)
+        emit aboutToBeDeleted(recs.first());
+    else
+        emit aboutToBeDeleted(recs);
+    QCoreApplication::processEvents();
+
+    // remove from db
+    foreach(DB::ResourceDirRecord* rec, recs)
+        api_->deleteResourceDir(rec->id);
 
-        // remove from source
-        if(!source_model_->removeRow(row, QModelIndex()))
-            return false;
+    // remove from storage
+    beginRemoveRows(QModelIndex(), row, row + count - 1);
+    for(int i = row + count - 1; i >= row; --i)
+        records_.removeAt(i);
+    endRemoveRows();
 
-        // remove from storage & delete pointer
-        records_.removeAt(row);
+    // delete pointers
+    while(recs.size() > 0) {
+        DB::ResourceDirRecord* rec = recs.first();
         delete rec;
         rec = 0;
-
-        // call super class function
-        QAbstractTableModel::removeRow(row, QModelIndex());
-
-        return true;
+        recs.pop_front();
     }
 
-    return false;
+    return true;
 }
 
-bool ResourceDirTableModel::removeRows(int row, int count, const QModelIndex&)
+void ResourceDirTableModel::removeAll()
 {
-    if(count < 0 || row < 0)
-        return false;
-
-    if(row < records_.size() && row+count < records_.size()) {
-
-        // collect all ResourceDirRecords being deleted
-        QList<DB::ResourceDirRecord*> recs;
-        for(int i = row; i <= row+count; ++i) {
-            DB::ResourceDirRecord* rec = getResourceDirByRow(i);
-            if(rec == 0)
-                return false;
-            recs.append(rec);
-        }
-
-        // signal deletion
-        emit aboutToBeDeleted(recs);
-        QCoreApplication::processEvents();
-
-        // remove from source model
-        if(!source_model_->removeRows(row, count, QModelIndex()))
-            return false;
-
-        // remove from storage
-        for(int i = row+count; i >= row; --i)
-            records_.removeAt(i);
-
-        // delete pointers
-        while(recs.size() > 0) {
-            DB::ResourceDirRecord* rec = recs.first();
-            delete rec;
-            rec = 0;
-            recs.pop_front();
-        }
-
-        // call super class function
-        QAbstractTableModel::removeRows(row, count, QModelIndex());
+    if(records_.size() == 0)
+        return;
 
-        return true;
-    }
+    emit aboutToBeDeleted(records_);
+    QCoreApplication::processEvents();
 
-    return false;
+    beginRemoveRows(QModelIndex(), 0, records_.size() - 1);
+    clear();
+    endRemoveRows();
 }
 
 void ResourceDirTableModel::update()
@@ -201,6 +179,8 @@ void ResourceDirTableModel::select()
         return;
     }
 
+    beginResetModel();
+
     if(records_.size() > 0)
         clear();
 
@@ -228,9 +208,7 @@ void ResourceDirTableModel::select()
         records_.append(rec);
     }
 
-    emit layoutAboutToBeChanged();
-    emit layoutChanged();
-    emit dataChanged(index(0,0), index(rowCount(), columnCount()));
+    endResetModel();
 }
 
 int ResourceDirTableModel::getRowByResourceDir(ResourceDirRecord *rec)
@@ -278,33 +256,33 @@ ResourceDirRecord *ResourceDirTableModel::getLastResourceDirRecord()
     return 0;
 }
 
-void ResourceDirTableModel::addResourceDirRecord(const QFileInfo &info)
+ResourceDirRecord* ResourceDirTableModel::addResourceDirRecord(const QFileInfo &info)
 {
     if(!info.isDir()) {
         qDebug() << "FAILURE: cannot add resourceDirRecord.";
         qDebug() << " > file info specified (" << info.filePath() << ") is not a directory.";
-        return;
+        return 0;
     }
 
     if(getResourceDirByPath(info.filePath()) != 0) {
         qDebug() << "FAILURE: cannot add ResourceDirRecord.";
         qDebug() << " > ResourceDir with path" << info.filePath() << "already exists.";
-        return;
+        return 0;
     }
 
-    api_->insertResourceDir(info);
-
-    int id = api_->getResourceDirId(info.filePath());
+    int id = api_->insertResourceDir(info);
     if(id == -1) {
         qDebug() << "FAILURE: Unknown error adding ResourceDirRecord";
         qDebug() << " > path:" << info.filePath();
-        return;
+        return 0;
     }
 
-    records_.append(new ResourceDirRecord(id, info.fileName(), info.filePath()));
+    ResourceDirRecord* rec = new ResourceDirRecord(id, info.fileName(), info.filePath());
+    beginInsertRows(QModelIndex(), records_.size(), records_.size());
+    records_.append(rec);
+    endInsertRows();
 
-    emit layoutAboutToBeChanged();
-    emit layoutChanged();
+    return rec;
 }
 
 const QList<ResourceDirRecord *> &ResourceDirTableModel::getResourceDirs() const
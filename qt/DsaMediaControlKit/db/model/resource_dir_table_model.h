@@ -50,6 +50,12 @@ public:
     /* Update model with data from db */
     void update();
 
+    /*
+     * Removes all ResourceDirRecords from this model, without touching the db.
+     * Use after all rows have been deleted from db.
+    */
+    void removeAll();
+
     /* Fills model with data from SoundFile database table **/
     void select();
 
@@ -84,9 +90,10 @@ public:
     ResourceDirRecord* getLastResourceDirRecord();
 
     /*
-    * Adds a ResourceDirRecord to this model
+    * Adds a ResourceDirRecord to this model.
+    * Returns the created ResourceDirRecord, 0 if adding failed.
     */
-    void addResourceDirRecord(const QFileInfo& info);
+    ResourceDirRecord* addResourceDirRecord(const QFileInfo& info);
 
     /*
     * Returns all ResourceDirRecords held by this model
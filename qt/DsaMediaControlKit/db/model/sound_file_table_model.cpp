@@ -2,6 +2,8 @@
 
 #include <QCoreApplication>
 #include <QDebug>
+#include <QMap>
+#include <QSqlRecord>
 
 namespace DB {
 namespace Model {
@@ -9,8 +11,11 @@ namespace Model {
 SoundFileTableModel::SoundFileTableModel(Core::Api* api, QObject* parent)
     : QAbstractTableModel(parent)
     , api_(api)
-    , source_model_(0)
     , records_()
+    , id_index_()
+    , path_index_()
+    , relative_path_index_()
+    , row_index_()
 {}
 
 SoundFileTableModel::~SoundFileTableModel()
@@ -112,80 +117,63 @@ bool SoundFileTableModel::removeColumns(int, int, const QModelIndex&)
     return false;
 }
 
-bool SoundFileTableModel::removeRow(int row, const QModelIndex&)
+bool SoundFileTableModel::removeRow(int row, const QModelIndex& parent)
 {
-    if(row < 0)
-        return false;
-
-    // collect SOundFileRecord being deleted
-    DB::SoundFileRecord* rec = getSoundFileByRow(row);
-    if(rec != 0) {
+    return removeRows(row, 1, parent);
+}
 
-        // signal deletion
-        emit aboutToBeDeleted(rec);
-        QCoreApplication::processEvents();
+bool SoundFileTableModel::removeRows(int row, int count, const QModelIndex&)
+{
+    if(count <= 0 || row < 0 || row + count > records_.size())
+        return false;
 
-        // remove from source
-        if(!source_model_->removeRow(row, QModelIndex()))
-            return false;
+    // collect all SoundFileRecords being deleted
+    QList<DB::SoundFileRecord*> recs = records_.mid(row, count);
 
-        // remove from storage & delete pointer
-        records_.removeAt(row);
+    // signal deletion
+    if(recs.size() == 1)
+        emit aboutToBeDeleted(recs.first());
+    else
+        emit aboutToBeDeleted(recs);
+    QCoreApplication::processEvents();
+
+    // remove from db
+    api_->beginTransaction();
+    foreach(DB::SoundFileRecord* rec, recs)
+        api_->deleteSoundFile(rec->id);
+    api_->commitTransaction();
+
+    // remove from storage
+    beginRemoveRows(QModelIndex(), row, row + count - 1);
+    foreach(DB::SoundFileRecord* rec, recs)
+        removeFromIndex(rec);
+    for(int i = row + count - 1; i >= row; --i)
+        records_.removeAt(i);
+    reindexRows(row);
+    endRemoveRows();
+
+    // delete pointers
+    while(recs.size() > 0) {
+        DB::SoundFileRecord* rec = recs.first();
         delete rec;
         rec = 0;
-
-        // call super class function
-        QAbstractTableModel::removeRow(row, QModelIndex());
-
-        return true;
+        recs.pop_front();
     }
 
-    return false;
+    return true;
 }
 
-bool SoundFileTableModel::removeRows(int row, int count, const QModelIndex&)
+void SoundFileTableModel::removeAll()
 {
-    if(count < 0 || row < 0)
-        return false;
-
-    if(row < records_.size() && row+count < records_.size()) {
-
-        // collect all SoundFileRecords being deleted
-        QList<DB::SoundFileRecord*> recs;
-        for(int i = row; i <= row+count; ++i) {
-            DB::SoundFileRecord* rec = getSoundFileByRow(i);
-            if(rec == 0)
-                return false;
-            recs.append(rec);
-        }
-
-        // signal deletion
-        emit aboutToBeDeleted(recs);
-        QCoreApplication::processEvents();
-
-        // remove from source model
-        if(!source_model_->removeRows(row, count, QModelIndex()))
-            return false;
-
-        // remove from storage
-        for(int i = row+count; i >= row; --i)
-            records_.removeAt(i);
-
-        // delete pointers
-        while(recs.size() > 0) {
-            DB::SoundFileRecord* rec = recs.first();
-            delete rec;
-            rec = 0;
-            recs.pop_front();
-        }
+    if(records_.size() == 0)
+        return;
 
-        // call super class function
-        QAbstractTableModel::removeRows(row, count, QModelIndex());
+    emit aboutToBeDeleted(records_);
+    QCoreApplication::processEvents();
 
-        return true;
-    }
-
-    return false;
+    beginRemoveRows(QModelIndex(), 0, records_.size() - 1);
+    clear();
+    endRemoveRows();
 }
 
 void SoundFileTableModel::update()
@@ -201,70 +189,26 @@ void SoundFileTableModel::select()
         return;
     }
 
-    if(records_.size() > 0)
-        clear();
-
-    source_model_ = api_->getSoundFileTable();
-
-    int c_id = source_model_->fieldIndex("id");
-    int c_name = source_model_->fieldIndex("name");
-    int c_path = source_model_->fieldIndex("path");
-    int c_rel_path = source_model_->fieldIndex("relative_path");
-    for(int row = 0; row < source_model_->rowCount(); ++row) {
-        SoundFileRecord* rec = new SoundFileRecord;
-
-        // set id
-        QModelIndex index = source_model_->index(row, c_id);
-        rec->id = source_model_->data(index).toInt();
-
-        // set name
-        index = source_model_->index(row, c_name);
-        rec->name = source_model_->data(index).toString();
-
-        // set path
-        index = source_model_->index(row, c_path);
-        rec->path = source_model_->data(index).toString();
-
-        // set relative path
-        index = source_model_->index(row, c_rel_path);
-        rec->relative_path = source_model_->data(index).toString();
-
-        // add to list of records
-        records_.append(rec);
-    }
-
-    emit layoutAboutToBeChanged();
-    emit layoutChanged();
-    emit dataChanged(index(0,0), index(rowCount(), columnCount()));
+    beginResetModel();
+    clear();
+    foreach(QSqlRecord const& res, api_->getSoundFiles())
+        appendRow(materialize(res));
+    endResetModel();
 }
 
 int SoundFileTableModel::getRowBySoundFile(SoundFileRecord *rec)
 {
-    for(int row = 0; row < records_.size(); ++row) {
-        if(records_[row] == rec)
-            return row;
-    }
-    return -1;
+    return row_index_.value(rec, -1);
 }
 
 SoundFileRecord *SoundFileTableModel::getSoundFileByPath(const QString &path)
 {
-    foreach(SoundFileRecord* rec, records_) {
-        if(rec->path.compare(path) == 0)
-            return rec;
-    }
-
-    return 0;
+    return path_index_.value(path, 0);
 }
 
 SoundFileRecord *SoundFileTableModel::getSoundFileById(int id)
 {
-    foreach(SoundFileRecord* rec, records_) {
-        if(rec->id == id)
-            return rec;
-    }
-
-    return 0;
+    return id_index_.value(id, 0);
 }
 
 SoundFileRecord *SoundFileTableModel::getSoundFileByRow(int row)
@@ -276,12 +220,35 @@ SoundFileRecord *SoundFileTableModel::getSoundFileByRow(int row)
 }
 
 QList<SoundFileRecord *> const SoundFileTableModel::getSoundFilesByRelativePath(const QString &rel_path)
+{
+    QList<SoundFileRecord*> sound_files = relative_path_index_.values(rel_path);
+
+    // order by id, like rows
+    if(sound_files.size() > 1) {
+        QMap<int, SoundFileRecord*> by_id;
+        foreach(SoundFileRecord* rec, sound_files)
+            by_id[rec->id] = rec;
+        sound_files = by_id.values();
+    }
+
+    return sound_files;
+}
+
+QList<SoundFileRecord *> const SoundFileTableModel::getSoundFilesByDbRecords(const QList<QSqlRecord> &records)
 {
     QList<SoundFileRecord*> sound_files;
-    foreach(SoundFileRecord* rec, records_) {
-        if(rec->relative_path.compare(rel_path) == 0)
-            sound_files.append(rec);
+    foreach(QSqlRecord const& res, records) {
+        // written to db after select(), becomes a row like all others
+        bool known = id_index_.contains(res.value("id").toInt());
+        SoundFileRecord* rec = materialize(res);
+        if(!known) {
+            beginInsertRows(QModelIndex(), records_.size(), records_.size());
+            appendRow(rec);
+            endInsertRows();
+        }
+        sound_files.append(rec);
     }
+
     return sound_files;
 }
 
@@ -293,36 +260,38 @@ SoundFileRecord *SoundFileTableModel::getLastSoundFileRecord()
     return 0;
 }
 
-void SoundFileTableModel::addSoundFileRecord(const QFileInfo& info, const ResourceDirRecord& resource_dir)
+SoundFileRecord* SoundFileTableModel::addSoundFileRecord(const QFileInfo& info, const ResourceDirRecord& resource_dir)
 {
     if(getSoundFileByPath(info.filePath()) != 0) {
         qDebug() << "FAILURE: cannot add SoundFileRecord.";
         qDebug() << " > SoundFile with path" << info.filePath() << "already exists.";
-        return;
+        return 0;
     }
 
     if(!info.filePath().startsWith(resource_dir.path)) {
         qDebug() << "FAILURE: cannot add SoundFileRecord.";
         qDebug() << " > ResourceDir" << resource_dir.path << "does not contain SoundFile" << info.filePath();
-        return;
+        return 0;
     }
 
-    api_->insertSoundFile(info, resource_dir);
-
-    int id = api_->getSoundFileId(info.filePath());
+    int id = api_->insertSoundFile(info, resource_dir);
     if(id == -1) {
         qDebug() << "FAILURE: Unknown error adding SoundFileRecord";
         qDebug() << " > path:" << info.filePath();
-        return;
+        return 0;
     }
 
     QString rel_path = info.filePath();
     rel_path.remove(0, resource_dir.path.size());
 
-    records_.append(new SoundFileRecord(id, info.fileName(), info.filePath(), rel_path));
+    SoundFileRecord* rec = new SoundFileRecord(id, info.fileName(), info.filePath(), rel_path);
+    addToIndex(rec);
 
-    emit layoutAboutToBeChanged();
-    emit layoutChanged();
+    beginInsertRows(QModelIndex(), records_.size(), records_.size());
+    appendRow(rec);
+    endInsertRows();
+
+    return rec;
 }
 
 const QList<SoundFileRecord *> &SoundFileTableModel::getSoundFiles() const
@@ -336,10 +305,21 @@ void SoundFileTableModel::deleteSoundFile(int id)
     if(rec == 0)
         return;
 
-    int row = getRowBySoundFile(rec);
+    removeRow(getRowBySoundFile(rec));
+}
+
+void SoundFileTableModel::setSoundFileWeight(int id, double weight)
+{
+    SoundFileRecord* rec = getSoundFileById(id);
+    if(rec == 0)
+        return;
 
-    if(row != -1)
-        removeRow(row);
+    weight = qMax(weight, 0.0);
+    if(!api_->updateSoundFileWeight(id, weight))
+        return;
+
+    rec->weight = weight;
+    emit weightChanged(rec);
 }
 
 bool SoundFileTableModel::indexIsValid(const QModelIndex & index) const
@@ -349,13 +329,71 @@ bool SoundFileTableModel::indexIsValid(const QModelIndex & index) const
 
 void SoundFileTableModel::clear()
 {
-    while(records_.size() > 0) {
-        SoundFileRecord* rec = records_.front();
-        records_.pop_front();
+    QList<SoundFileRecord*> recs = records_;
+
+    id_index_.clear();
+    path_index_.clear();
+    relative_path_index_.clear();
+    row_index_.clear();
+    records_.clear();
+
+    while(recs.size() > 0) {
+        SoundFileRecord* rec = recs.front();
+        recs.pop_front();
         delete rec;
     }
 }
 
+SoundFileRecord *SoundFileTableModel::materialize(const QSqlRecord &res)
+{
+    int id = res.value("id").toInt();
+
+    // keep pointers handed out before stable
+    SoundFileRecord* rec = id_index_.value(id, 0);
+    if(rec != 0)
+        return rec;
+
+    rec = new SoundFileRecord(
+        id,
+        res.value("name").toString(),
+        res.value("path").toString(),
+        res.value("relative_path").toString(),
+        res.value("weight").isNull() ? 1.0 : res.value("weight").toDouble()
+    );
+    addToIndex(rec);
+
+    return rec;
+}
+
+void SoundFileTableModel::appendRow(SoundFileRecord *rec)
+{
+    records_.append(rec);
+    row_index_[rec] = records_.size() - 1;
+}
+
+void SoundFileTableModel::addToIndex(SoundFileRecord *rec)
+{
+    id_index_[rec->id] = rec;
+    path_index_[rec->path] = rec;
+    relative_path_index_.insert(rec->relative_path, rec);
+}
+
+void SoundFileTableModel::removeFromIndex(SoundFileRecord *rec)
+{
+    if(id_index_.value(rec->id, 0) == rec)
+        id_index_.remove(rec->id);
+    if(path_index_.value(rec->path, 0) == rec)
+        path_index_.remove(rec->path);
+    relative_path_index_.remove(rec->relative_path, rec);
+    row_index_.remove(rec);
+}
+
+void SoundFileTableModel::reindexRows(int from_row)
+{
+    for(int row = qMax(from_row, 0); row < records_.size(); ++row)
+        row_index_[records_[row]] = row;
+}
+
 } // namespace Model
 } // namespace DB
 
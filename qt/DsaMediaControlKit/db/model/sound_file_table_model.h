@@ -2,6 +2,9 @@
 #define DB_MODEL_SOUND_FILE_TABLE_MODEL_H
 
 #include <QAbstractTableModel>
+#include <QHash>
+#include <QMultiHash>
+
 #include "db/core/api.h"
 #include "db/table_records.h"
 
@@ -12,6 +15,11 @@ namespace Model {
  * Class derived from QAbstractTableModel.
  * Builds a tablemodel based on the sound_file db table of this application.
  * Provides convenience functions for accessing & managing SoundFileRecords maintained by it.
+ * select() loads all rows ordered by id with one query, each SoundFileRecord
+ * stays valid until it gets deleted. Records are never evicted, as playlists
+ * and views keep pointers to them, so memory grows with the library.
+ * Lookups by id, path, relative path and record are served from hash indexes,
+ * which are kept in sync with the list of records.
 */
 
 class SoundFileTableModel : public QAbstractTableModel
@@ -56,7 +64,13 @@ public:
     /* Update model with data from db */
     void update();
 
-    /* Fills model with data from SoundFile database table **/
+    /*
+     * Removes all SoundFileRecords from this model, without touching the db.
+     * Use after all rows have been deleted from db.
+    */
+    void removeAll();
+
+    /* Fills model with all rows of SoundFile database table **/
     void select();
 
     /*
@@ -89,6 +103,13 @@ public:
     */
     QList<SoundFileRecord*> const getSoundFilesByRelativePath(QString const& rel_path);
 
+    /*
+     * Gets the SoundFileRecords for given sound_file db records
+     * (columns id, name, path, relative_path), keeping their order.
+     * Records not known so far get created and appended as rows.
+    */
+    QList<SoundFileRecord*> const getSoundFilesByDbRecords(QList<QSqlRecord> const& records);
+
     /*
      * Gets last SoundFileRecord in the model.
      * Returns 0 if none found.
@@ -96,21 +117,28 @@ public:
     SoundFileRecord* getLastSoundFileRecord();
 
     /*
-    * Adds a SoundFileRecord to this model
+    * Adds a SoundFileRecord to this model.
+    * Returns the created SoundFileRecord, 0 if adding failed.
     */
-    void addSoundFileRecord(
+    SoundFileRecord* addSoundFileRecord(
         const QFileInfo& info,
         const ResourceDirRecord& resource_dir
     );
 
     /*
-    * Returns all SoundFileRecords held by this model
+    * Returns all SoundFileRecords.
     */
     QList<DB::SoundFileRecord*> const& getSoundFiles() const;
 
 public slots:
     void deleteSoundFile(int id);
 
+    /*
+     * Sets playback weight of SoundFile referenced by id (db and record).
+     * Negative weights are stored as 0.
+    */
+    void setSoundFileWeight(int id, double weight);
+
 signals:
     /* triggered and processed before SoundFileRecord gets deleted */
     void aboutToBeDeleted(DB::SoundFileRecord*);
@@ -118,6 +146,9 @@ signals:
     /* triggered and processed before SoundFileRecords get deleted */
     void aboutToBeDeleted(const QList<DB::SoundFileRecord*>&);
 
+    /* triggered after playback weight of SoundFileRecord changed */
+    void weightChanged(DB::SoundFileRecord*);
+
 private:
     /* validates existance of given QModelIndex for this model **/
     bool indexIsValid(const QModelIndex&) const;
@@ -125,9 +156,32 @@ private:
     /* Clears all SoundFileRecords from records **/
     void clear();
 
+    /*
+     * Returns the SoundFileRecord for given db record.
+     * Record will be created if it does not exist so far.
+    **/
+    SoundFileRecord* materialize(QSqlRecord const& res);
+
+    /* Appends given record as last row **/
+    void appendRow(SoundFileRecord* rec);
+
+    /* Adds given record to lookup indexes of id, path and relative path **/
+    void addToIndex(SoundFileRecord* rec);
+
+    /* Removes given record from all lookup indexes **/
+    void removeFromIndex(SoundFileRecord* rec);
+
+    /* Updates row index of all records starting at given row **/
+    void reindexRows(int from_row);
+
     Core::Api* api_;
-    QSqlRelationalTableModel* source_model_;
     QList<SoundFileRecord*> records_;
+
+    // lookup indexes
+    QHash<int, SoundFileRecord*> id_index_;
+    QHash<QString, SoundFileRecord*> path_index_;
+    QMultiHash<QString, SoundFileRecord*> relative_path_index_;
+    QHash<SoundFileRecord*, int> row_index_;
 };
 
 } // namespace Model
@@ -12,6 +12,12 @@ SoundFile::SoundFile(QFileInfo const& info, ResourceDirRecord const& resource_di
     computeCategoryPath();
 }
 
+SoundFile::SoundFile()
+    : file_info_()
+    , category_path_()
+    , resource_dir_()
+{}
+
 const QStringList &SoundFile::getCategoryPath() const
 {
     return category_path_;
@@ -3,6 +3,7 @@
 
 #include <QFileInfo>
 #include <QStringList>
+#include <QMetaType>
 
 #include "db/table_records.h"
 
@@ -18,6 +19,7 @@ class SoundFile
 {
 public:
     SoundFile(QFileInfo const&, ResourceDirRecord const&);
+    SoundFile();
 
     /*
      * Gets the category tree path of this instance.
@@ -48,4 +50,7 @@ private:
 
 } // namespace DB
 
+// allows passing SoundFiles through queued connections
+Q_DECLARE_METATYPE(DB::SoundFile)
+
 #endif // DB_SOUND_FILE_H
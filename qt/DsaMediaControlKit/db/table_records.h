@@ -96,23 +96,27 @@ struct CategoryRecord : TableRecord {
 struct SoundFileRecord : TableRecord {
     QString path;
     QString relative_path;
+    double weight; // relative probability in weighted playback
 
-    SoundFileRecord(int i, QString const& n, QString const& p = "", QString const& rel_p = "")
+    SoundFileRecord(int i, QString const& n, QString const& p = "", QString const& rel_p = "", double w = 1.0)
         : TableRecord(SOUND_FILE, i, n)
         , path(p)
         , relative_path(rel_p)
+        , weight(w)
     {}
 
     SoundFileRecord()
         : TableRecord(SOUND_FILE, -1, "")
         , path("")
         , relative_path("")
+        , weight(1.0)
     {}
 
     SoundFileRecord(const SoundFileRecord& rec)
         : TableRecord(SOUND_FILE, rec.id, rec.name)
         , path(rec.path)
         , relative_path(rec.relative_path)
+        , weight(rec.weight)
     {}
 
     virtual ~SoundFileRecord() {}
@@ -124,6 +128,7 @@ struct SoundFileRecord : TableRecord {
         SoundFileRecord* sf_rec = (SoundFileRecord*) rec;
         path = sf_rec->path;
         relative_path = sf_rec->relative_path;
+        weight = sf_rec->weight;
 
         return true;
     }
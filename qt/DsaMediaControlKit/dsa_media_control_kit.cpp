@@ -1,15 +1,22 @@
 #include "dsa_media_control_kit.h"
 
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QDir>
 #include <QKeySequence>
 #include <QJsonDocument>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QInputDialog>
+#include <QTimer>
 
 #include "db/core/api.h"
 #include "resources/resources.h"
 #include "misc/json_mime_data_parser.h"
+#include "misc/project_file.h"
+#include "misc/random_service.h"
+#include "audio/mixer.h"
+#include "audio/pcm_cache.h"
 
 DsaMediaControlKit::DsaMediaControlKit(QWidget *parent)
     : QWidget(parent)
@@ -17,20 +24,26 @@ DsaMediaControlKit::DsaMediaControlKit(QWidget *parent)
     , actions_()
     , main_menu_(0)
     , sound_file_view_(0)
+    , search_edit_(0)
     , category_view_(0)
     , preset_view_(0)
+    , master_volume_slider_(0)
     , sound_file_importer_(0)
     , center_h_splitter_(0)
     , left_v_splitter_(0)
     , left_box_(0)
     , right_box_(0)
     , db_handler_(0)
+    , autosave_(0)
 {
     initDB();
     initWidgets();
     initLayout();
     initActions();
     initMenu();
+
+    // asks for recovery once the window is shown
+    QTimer::singleShot(0, this, SLOT(onStartAutosave()));
 }
 
 QMenu *DsaMediaControlKit::getMenu()
@@ -49,7 +62,7 @@ QProgressBar *DsaMediaControlKit::getProgressBar() const
 }
 
 
-void DsaMediaControlKit::onProgressChanged(int value)
+void DsaMediaControlKit::onProgressChanged(int value, int files_per_sec)
 {
     if(value != 100) {
         if(progress_bar_->isHidden()) {
@@ -59,6 +72,12 @@ void DsaMediaControlKit::onProgressChanged(int value)
     else {
         progress_bar_->hide();
     }
+
+    if(files_per_sec > 0)
+        progress_bar_->setFormat("%p% (" + QString::number(files_per_sec) + " " + tr("files/sec") + ")");
+    else
+        progress_bar_->setFormat("%p%");
+
     progress_bar_->setValue(value);
 }
 
@@ -71,6 +90,21 @@ void DsaMediaControlKit::onSelectedCategoryChanged(DB::CategoryRecord *rec)
     sound_file_view_->setSoundFiles(db_handler_->getSoundFileRecordsByCategoryId(id));
 }
 
+void DsaMediaControlKit::onSearchTextChanged(const QString &text)
+{
+    if(text.trimmed().size() == 0) {
+        category_view_->selectRoot();
+        return;
+    }
+
+    sound_file_view_->setSoundFiles(db_handler_->searchSoundFiles(text));
+}
+
+void DsaMediaControlKit::onMasterVolumeChanged(int volume)
+{
+    Audio::Mixer::instance()->setMasterVolume(volume);
+}
+
 void DsaMediaControlKit::onDeleteDatabase()
 {
     db_handler_->deleteAll();
@@ -79,20 +113,25 @@ void DsaMediaControlKit::onDeleteDatabase()
 
 void DsaMediaControlKit::onSaveProjectAs()
 {
+    QString binary_filter = tr("Binary Project (*%1)").arg(PROJECT_BINARY_SUFFIX);
+    QString selected_filter;
     QString file_name = QFileDialog::getSaveFileName(
         this, tr("Save Project"),
         "",
-        tr("JSON (*.json)")
+        tr("JSON (*.json)") + ";;" + binary_filter,
+        &selected_filter
     );
 
     if(file_name.size() > 0) {
-        QJsonDocument doc;
+        if(selected_filter == binary_filter && !Misc::ProjectFile::isBinary(file_name))
+            file_name += PROJECT_BINARY_SUFFIX;
 
-        doc.setObject(preset_view_->toJsonObject());
+        // seed is stored, so shuffle & delays repeat when project is reopened
+        QJsonObject obj = preset_view_->toJsonObject();
+        obj["random_seed"] = (double) Misc::RandomService::instance()->getSeed();
 
-        QFile json_file(file_name);
-        json_file.open(QFile::WriteOnly);
-        json_file.write(doc.toJson());
+        if(!Misc::ProjectFile::write(file_name, obj))
+            emit statusMessageUpdated(tr("The project could not be saved."));
     }
 }
 
@@ -101,14 +140,16 @@ void DsaMediaControlKit::onOpenProject()
     QString file_name = QFileDialog::getOpenFileName(
         this, tr("Open Project"),
         "",
-        tr("JSON (*.json)")
+        tr("Projects (*.json *%1)").arg(PROJECT_BINARY_SUFFIX)
     );
 
     if(file_name.size() > 0) {
-        QFile json_file(file_name);
+        QElapsedTimer timer;
+        timer.start();
 
         // opening failed
-        if(!json_file.open(QFile::ReadOnly)) {
+        QJsonObject obj;
+        if(!Misc::ProjectFile::read(file_name, &obj)) {
             QMessageBox b;
             b.setText(tr("The selected file could not be opened."));
             b.setInformativeText(tr("Do you wish to select a different file?"));
@@ -116,14 +157,22 @@ void DsaMediaControlKit::onOpenProject()
             b.setDefaultButton(QMessageBox::Yes);
             if(b.exec() == QMessageBox::Yes)
                 onOpenProject();
-            else
-                return;
+            return;
         }
 
-        QJsonDocument doc = QJsonDocument::fromJson(json_file.readAll());
+        qDebug() << "NOTIFICATION: Read project file" << file_name;
+        qDebug() << " > read and parse" << (Misc::ProjectFile::isBinary(file_name) ? "binary:" : "JSON:")
+                 << timer.nsecsElapsed() / 1e6 << "ms";
+
+        // projects without seed get a new one
+        Misc::RandomService* random = Misc::RandomService::instance();
+        if(obj.contains("random_seed"))
+            random->setSeed((quint32) obj["random_seed"].toDouble());
+        else
+            random->setSeed(Misc::RandomService::generateSeed());
 
         // graphics view could not be set from json
-        if(!preset_view_->setFromJsonObject(doc.object())) {
+        if(!preset_view_->setFromJsonObject(obj)) {
             QMessageBox b;
             b.setText(tr("The selected file does not seem to contain valid project data."));
             b.setInformativeText(tr("Do you wish to select a different file?"));
@@ -131,17 +180,128 @@ void DsaMediaControlKit::onOpenProject()
             b.setDefaultButton(QMessageBox::Yes);
             if(b.exec() == QMessageBox::Yes)
                 onOpenProject();
+            return;
+        }
+
+        // journal of previous board is obsolete
+        autosave_->snapshot();
+    }
+}
+
+void DsaMediaControlKit::onSetRandomSeed()
+{
+    bool ok = false;
+    int seed = QInputDialog::getInt(
+        this, tr("Set Random Seed"),
+        tr("Seed for shuffle and delay intervals of this project:"),
+        (int) (Misc::RandomService::instance()->getSeed() & 0x7fffffff),
+        0, 0x7fffffff, 1, &ok
+    );
+
+    if(ok)
+        Misc::RandomService::instance()->setSeed((quint32) seed);
+}
+
+void DsaMediaControlKit::onSetAudioCacheSize()
+{
+    Audio::PcmCache* cache = Audio::PcmCache::instance();
+
+    bool ok = false;
+    int mib = QInputDialog::getInt(
+        this, tr("Set Audio Cache Size"),
+        tr("Memory for decoded sounds of key bound and instant tiles (MiB):"),
+        (int) (cache->getBudget() / (1024 * 1024)),
+        0, 16384, 64, &ok
+    );
+
+    if(ok)
+        cache->setBudget((qint64) mib * 1024 * 1024);
+}
+
+void DsaMediaControlKit::onRecordSession(bool record)
+{
+    Misc::RandomService* random = Misc::RandomService::instance();
+    if(record) {
+        random->startRecording();
+        emit statusMessageUpdated(tr("Recording session..."));
+        return;
+    }
+
+    random->stopRecording();
+
+    QString file_name = QFileDialog::getSaveFileName(
+        this, tr("Save Session Recording"),
+        "",
+        tr("JSON (*.json)")
+    );
+
+    if(file_name.size() > 0) {
+        QJsonDocument doc(random->getRecording());
+
+        QFile json_file(file_name);
+        json_file.open(QFile::WriteOnly);
+        json_file.write(doc.toJson());
+    }
+}
+
+void DsaMediaControlKit::onReplaySession()
+{
+    QString file_name = QFileDialog::getOpenFileName(
+        this, tr("Replay Session Recording"),
+        "",
+        tr("JSON (*.json)")
+    );
+
+    if(file_name.size() == 0)
+        return;
+
+    QFile json_file(file_name);
+    if(!json_file.open(QFile::ReadOnly))
+        return;
+
+    QJsonDocument doc = QJsonDocument::fromJson(json_file.readAll());
+    if(Misc::RandomService::instance()->startReplay(doc.object()))
+        emit statusMessageUpdated(tr("Replaying session recording."));
+    else
+        emit statusMessageUpdated(tr("The selected file does not contain a session recording."));
+}
+
+void DsaMediaControlKit::onStartAutosave()
+{
+    // files of previous session remain, if program crashed
+    if(autosave_->hasRecovery()) {
+        QMessageBox b;
+        b.setText(tr("The previous session was not closed properly."));
+        b.setInformativeText(tr("Do you wish to restore the autosaved board?"));
+        b.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
+        b.setDefaultButton(QMessageBox::Yes);
+        if(b.exec() == QMessageBox::Yes) {
+            QJsonObject obj = autosave_->recover();
+            if(obj.contains("random_seed"))
+                Misc::RandomService::instance()->setSeed((quint32) obj["random_seed"].toDouble());
+
+            if(!preset_view_->setFromJsonObject(obj))
+                emit statusMessageUpdated(tr("The autosaved board could not be restored."));
         }
     }
+
+    autosave_->start();
 }
 
 void DsaMediaControlKit::initWidgets()
 {
+    // master list shows the whole library, loaded by the model on startup
+    DB::Model::SoundFileTableModel* sound_file_model = db_handler_->getSoundFileTableModel();
+
     sound_file_view_ = new SoundFile::MasterView(
-        db_handler_->getSoundFileTableModel()->getSoundFiles(),
+        sound_file_model->getSoundFiles(),
         this
     );
 
+    search_edit_ = new QLineEdit(this);
+    search_edit_->setPlaceholderText(tr("Search sound files..."));
+    search_edit_->setClearButtonEnabled(true);
+
     progress_bar_ = new QProgressBar;
     progress_bar_->setMaximum(100);
     progress_bar_->setMinimum(0);
@@ -151,6 +311,13 @@ void DsaMediaControlKit::initWidgets()
     preset_view_ = new TwoD::GraphicsView(this);
     preset_view_->setSoundFileModel(db_handler_->getSoundFileTableModel());
 
+    autosave_ = new Misc::Autosave(preset_view_, this);
+
+    master_volume_slider_ = new QSlider(Qt::Horizontal, this);
+    master_volume_slider_->setRange(0, 100);
+    master_volume_slider_->setValue(Audio::Mixer::instance()->getMasterVolume());
+    master_volume_slider_->setToolTip(tr("Master Volume"));
+
     sound_file_importer_ = new SoundFile::ResourceImporter(
         db_handler_->getResourceDirTableModel(),
         this
@@ -175,16 +342,28 @@ void DsaMediaControlKit::initWidgets()
     center_h_splitter_->setStretchFactor(0, 0);
     center_h_splitter_->setStretchFactor(1, 10);
 
-    connect(sound_file_importer_, SIGNAL(folderImported(QList<DB::SoundFile> const&)),
-            db_handler_, SLOT(insertSoundFilesAndCategories(QList<DB::SoundFile> const&)));
+    connect(sound_file_importer_, SIGNAL(soundFilesParsed(QList<DB::SoundFile> const&)),
+            db_handler_, SLOT(insertSoundFiles(QList<DB::SoundFile> const&)));
     connect(sound_file_importer_, SIGNAL(folderImported()),
             category_view_, SLOT(selectRoot()));
+    connect(sound_file_importer_, SIGNAL(progressChanged(int,int)),
+            this, SLOT(onProgressChanged(int,int)));
+    connect(sound_file_importer_, SIGNAL(importRunning(bool)),
+            db_handler_, SLOT(setBulkImport(bool)));
+    connect(sound_file_importer_, SIGNAL(statusMessageUpdated(QString const&)),
+            this, SIGNAL(statusMessageUpdated(QString const&)));
     connect(db_handler_, SIGNAL(progressChanged(int)),
             this, SLOT(onProgressChanged(int)));
     connect(category_view_, SIGNAL(categorySelected(DB::CategoryRecord*)),
             this, SLOT(onSelectedCategoryChanged(DB::CategoryRecord*)));
+    connect(search_edit_, SIGNAL(textChanged(QString const&)),
+            this, SLOT(onSearchTextChanged(QString const&)));
+    connect(master_volume_slider_, SIGNAL(valueChanged(int)),
+            this, SLOT(onMasterVolumeChanged(int)));
     connect(sound_file_view_, SIGNAL(deleteSoundFileRequested(int)),
             db_handler_->getSoundFileTableModel(), SLOT(deleteSoundFile(int)));
+    connect(sound_file_view_, SIGNAL(soundFileWeightChangeRequested(int,double)),
+            db_handler_->getSoundFileTableModel(), SLOT(setSoundFileWeight(int,double)));
     connect(db_handler_->getSoundFileTableModel(), SIGNAL(aboutToBeDeleted(DB::SoundFileRecord*)),
             sound_file_view_, SLOT(onSoundFileAboutToBeDeleted(DB::SoundFileRecord*)));
 }
@@ -195,11 +374,13 @@ void DsaMediaControlKit::initLayout()
 
     // left layout
     QVBoxLayout* l_layout = new QVBoxLayout;
+    l_layout->addWidget(search_edit_);
     l_layout->addWidget(left_v_splitter_);
     left_box_->setLayout(l_layout);
 
     // right layout
     QVBoxLayout* r_layout = new QVBoxLayout;
+    r_layout->addWidget(master_volume_slider_);
     r_layout->addWidget(preset_view_);
     right_box_->setLayout(r_layout);
 
@@ -214,6 +395,10 @@ void DsaMediaControlKit::initActions()
     actions_["Import Resource Folder..."]->setToolTip(tr("Imports a folder of resources into the program."));
     actions_["Import Resource Folder..."]->setShortcut(QKeySequence(tr("Ctrl+Shift+O")));
 
+    actions_["Cancel Import"] = new QAction(tr("Cancel Import"), this);
+    actions_["Cancel Import"]->setToolTip(tr("Stops the running resource folder import."));
+    actions_["Cancel Import"]->setEnabled(false);
+
     actions_["Delete Database Contents..."] = new QAction(tr("Delete Database Contents..."), this);
     actions_["Delete Database Contents..."]->setToolTip(tr("Deletes all contents from application database."));
 
@@ -226,14 +411,39 @@ void DsaMediaControlKit::initActions()
     actions_["Open Project..."]->setShortcut(QKeySequence(tr("Ctrl+O")));
 
 
+    actions_["Set Random Seed..."] = new QAction(tr("Set Random Seed..."), this);
+    actions_["Set Random Seed..."]->setToolTip(tr("Sets the seed for shuffle and delay intervals, stored with the project."));
+
+    actions_["Set Audio Cache Size..."] = new QAction(tr("Set Audio Cache Size..."), this);
+    actions_["Set Audio Cache Size..."]->setToolTip(tr("Sets the memory used to keep sounds decoded for instant playback."));
+
+    actions_["Record Session"] = new QAction(tr("Record Session"), this);
+    actions_["Record Session"]->setToolTip(tr("Records all random tracks and delays, so the session can be replayed."));
+    actions_["Record Session"]->setCheckable(true);
+
+    actions_["Replay Session Recording..."] = new QAction(tr("Replay Session Recording..."), this);
+    actions_["Replay Session Recording..."]->setToolTip(tr("Plays the tracks and delays of a recorded session again."));
+
     connect(actions_["Import Resource Folder..."] , SIGNAL(triggered(bool)),
             sound_file_importer_, SLOT(startBrowseFolder(bool)));
+    connect(actions_["Cancel Import"], SIGNAL(triggered()),
+            sound_file_importer_, SLOT(cancelImport()));
+    connect(sound_file_importer_, SIGNAL(importRunning(bool)),
+            actions_["Cancel Import"], SLOT(setEnabled(bool)));
     connect(actions_["Delete Database Contents..."], SIGNAL(triggered()),
             this, SLOT(onDeleteDatabase()));
     connect(actions_["Save Project As..."], SIGNAL(triggered()),
             this, SLOT(onSaveProjectAs()));
     connect(actions_["Open Project..."], SIGNAL(triggered()),
             this, SLOT(onOpenProject()));
+    connect(actions_["Set Random Seed..."], SIGNAL(triggered()),
+            this, SLOT(onSetRandomSeed()));
+    connect(actions_["Set Audio Cache Size..."], SIGNAL(triggered()),
+            this, SLOT(onSetAudioCacheSize()));
+    connect(actions_["Record Session"], SIGNAL(toggled(bool)),
+            this, SLOT(onRecordSession(bool)));
+    connect(actions_["Replay Session Recording..."], SIGNAL(triggered()),
+            this, SLOT(onReplaySession()));
 }
 
 void DsaMediaControlKit::initMenu()
@@ -245,9 +455,17 @@ void DsaMediaControlKit::initMenu()
     add_menu->addAction(actions_["Open Project..."]);
     add_menu->addSeparator();
     add_menu->addAction(actions_["Import Resource Folder..."]);
+    add_menu->addAction(actions_["Cancel Import"]);
     add_menu->addSeparator();
     add_menu->addAction(actions_["Delete Database Contents..."]);
 
+    QMenu* session_menu = main_menu_->addMenu(tr("Session"));
+    session_menu->addAction(actions_["Set Random Seed..."]);
+    session_menu->addAction(actions_["Set Audio Cache Size..."]);
+    session_menu->addSeparator();
+    session_menu->addAction(actions_["Record Session"]);
+    session_menu->addAction(actions_["Replay Session Recording..."]);
+
     main_menu_->addMenu(add_menu);
 }
 
@@ -14,6 +14,8 @@
 #include <QProgressBar>
 #include <QSplitter>
 #include <QScrollArea>
+#include <QLineEdit>
+#include <QSlider>
 
 
 #include "misc/drop_group_box.h"
@@ -22,6 +24,7 @@
 #include "db/handler.h"
 #include "category/tree_view.h"
 #include "2D/graphics_view.h"
+#include "misc/autosave.h"
 
 class DsaMediaControlKit : public QWidget
 {
@@ -39,11 +42,18 @@ signals:
 public slots:
 
 private slots:
-    void onProgressChanged(int);
+    void onProgressChanged(int value, int files_per_sec = 0);
     void onSelectedCategoryChanged(DB::CategoryRecord* rec);
+    void onSearchTextChanged(QString const& text);
+    void onMasterVolumeChanged(int volume);
     void onDeleteDatabase();
     void onSaveProjectAs();
     void onOpenProject();
+    void onSetRandomSeed();
+    void onSetAudioCacheSize();
+    void onRecordSession(bool record);
+    void onReplaySession();
+    void onStartAutosave();
 
 private:
     void initWidgets();
@@ -62,9 +72,11 @@ private:
 
     // WIDGETS
     SoundFile::MasterView* sound_file_view_;
+    QLineEdit* search_edit_;
     Category::TreeView* category_view_;
 
     TwoD::GraphicsView* preset_view_;
+    QSlider* master_volume_slider_;
     SoundFile::ResourceImporter* sound_file_importer_;
     QSplitter* center_h_splitter_;
     QSplitter* left_v_splitter_;
@@ -73,6 +85,9 @@ private:
 
     // DB handler
     DB::Handler* db_handler_;
+
+    // AUTOSAVE of the preset view
+    Misc::Autosave* autosave_;
 };
 
 #endif // DSAMEDIACONTROLKIT_H
@@ -4,12 +4,69 @@
 #include <QDebug>
 #include <QTimer>
 #include "resources/resources.h"
+#include "_TEST/mixer_benchmark.h"
+#include "_TEST/layout_benchmark.h"
+#include "_TEST/render_benchmark.h"
+#include "_TEST/project_format_benchmark.h"
+#include "_TEST/record_parser_benchmark.h"
+#include "_TEST/lookup_benchmark.h"
+#include "_TEST/category_query_benchmark.h"
+#include "_TEST/schema_check.h"
+#include "_TEST/scheduler_check.h"
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
 
+    if(a.arguments().contains("--mixer-benchmark")) {
+        _TEST::MixerBenchmark::run();
+        return 0;
+    }
+
+    if(a.arguments().contains("--layout-benchmark")) {
+        _TEST::LayoutBenchmark::run();
+        return 0;
+    }
+
+    if(a.arguments().contains("--record-benchmark")) {
+        _TEST::RecordParserBenchmark::run();
+        return 0;
+    }
+
+    if(a.arguments().contains("--lookup-benchmark")) {
+        _TEST::LookupBenchmark::run();
+        return 0;
+    }
+
+    if(a.arguments().contains("--category-benchmark")) {
+        _TEST::CategoryQueryBenchmark::run();
+        return 0;
+    }
+
+    // fails with exit code 1 if a query does not use its index
+    if(a.arguments().contains("--schema-check"))
+        return _TEST::SchemaCheck::run() ? 0 : 1;
+
+    // fails with exit code 1 if draws do not follow the weights
+    if(a.arguments().contains("--scheduler-check"))
+        return _TEST::SchedulerCheck::run() ? 0 : 1;
+
+    // project files to compare follow the option
+    int project_arg = a.arguments().indexOf("--project-benchmark");
+    if(project_arg != -1) {
+        _TEST::ProjectFormatBenchmark::run(a.arguments().mid(project_arg + 1));
+        return 0;
+    }
+
     Resources::init();
+
+    // tiles paint resource pixmaps
+    if(a.arguments().contains("--render-benchmark")) {
+        _TEST::RenderBenchmark::run();
+        Resources::cleanup();
+        return 0;
+    }
+
     a.setStyleSheet(Resources::DARK_STYLE);
 
     MainWindow w;
@@ -69,4 +69,7 @@ void MainWindow::initMenuBar()
 void MainWindow::initStatusBar()
 {
     statusBar()->addWidget(kit_->getProgressBar(), 1);
+
+    connect(kit_, SIGNAL(statusMessageUpdated(QString const&)),
+            statusBar(), SLOT(showMessage(QString const&)));
 }
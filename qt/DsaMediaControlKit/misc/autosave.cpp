@@ -0,0 +1,383 @@
+#include "autosave.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonArray>
+
+#include "resources/resources.h"
+#include "misc/project_file.h"
+#include "misc/random_service.h"
+
+// changes of a tile within this time are journaled as one entry (ms)
+#define AUTOSAVE_FLUSH_DELAY 1000
+// journal is compacted into a snapshot in this interval, if it has entries (ms)
+#define AUTOSAVE_COMPACT_INTERVAL 60000
+// journal is compacted after this number of entries
+#define AUTOSAVE_MAX_ENTRIES 200
+
+#define AUTOSAVE_JOURNAL_FILE "autosave.journal"
+#define AUTOSAVE_SNAPSHOT_FILE "autosave" PROJECT_BINARY_SUFFIX
+
+namespace Misc {
+
+AutosaveWriter::AutosaveWriter(const QString &dir)
+    : QObject()
+    , dir_(dir)
+    , journal_(QDir(dir).filePath(AUTOSAVE_JOURNAL_FILE))
+{}
+
+void AutosaveWriter::append(const QByteArray &lines)
+{
+    if(!journal_.isOpen()) {
+        QDir().mkpath(dir_);
+        if(!journal_.open(QFile::WriteOnly | QFile::Append)) {
+            qDebug() << "FAILURE: Could not open autosave journal";
+            qDebug() << " > File:" << journal_.fileName();
+            return;
+        }
+    }
+
+    // entries are flushed right away, so they survive a crash of the program
+    journal_.write(lines);
+    journal_.flush();
+}
+
+void AutosaveWriter::writeSnapshot(const QJsonObject &project)
+{
+    QDir().mkpath(dir_);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // snapshot is replaced atomically, journal stays valid until it is written
+    if(!ProjectFile::write(QDir(dir_).filePath(AUTOSAVE_SNAPSHOT_FILE), project)) {
+        qDebug() << "FAILURE: Could not write autosave snapshot";
+        qDebug() << " > Directory:" << dir_;
+        return;
+    }
+
+    if(journal_.isOpen())
+        journal_.close();
+    journal_.open(QFile::WriteOnly | QFile::Truncate);
+
+    qDebug() << "NOTIFICATION: Compacted autosave journal into snapshot";
+    qDebug() << " > write:" << timer.nsecsElapsed() / 1e6 << "ms";
+}
+
+void AutosaveWriter::discard()
+{
+    if(journal_.isOpen())
+        journal_.close();
+    QFile::remove(QDir(dir_).filePath(AUTOSAVE_JOURNAL_FILE));
+    QFile::remove(QDir(dir_).filePath(AUTOSAVE_SNAPSHOT_FILE));
+}
+
+Autosave::Autosave(TwoD::GraphicsView *view, QObject *parent)
+    : QObject(parent)
+    , view_(view)
+    , dir_(Resources::AUTOSAVE_DIR)
+    , started_(false)
+    , states_()
+    , modified_()
+    , entries_since_snapshot_(0)
+    , flush_timer_(0)
+    , compact_timer_(0)
+    , thread_()
+    , writer_(0)
+{
+    flush_timer_ = new QTimer(this);
+    flush_timer_->setSingleShot(true);
+    flush_timer_->setInterval(AUTOSAVE_FLUSH_DELAY);
+    connect(flush_timer_, SIGNAL(timeout()),
+            this, SLOT(flush()));
+
+    compact_timer_ = new QTimer(this);
+    compact_timer_->setInterval(AUTOSAVE_COMPACT_INTERVAL);
+    connect(compact_timer_, SIGNAL(timeout()),
+            this, SLOT(compact()));
+
+    writer_ = new AutosaveWriter(dir_);
+    writer_->moveToThread(&thread_);
+    connect(&thread_, SIGNAL(finished()),
+            writer_, SLOT(deleteLater()));
+    connect(this, SIGNAL(appendRequested(QByteArray)),
+            writer_, SLOT(append(QByteArray)));
+    connect(this, SIGNAL(snapshotRequested(QJsonObject)),
+            writer_, SLOT(writeSnapshot(QJsonObject)));
+    thread_.start(QThread::LowPriority);
+
+    connect(view_, SIGNAL(tileAdded(TwoD::Tile*)),
+            this, SLOT(onTileAdded(TwoD::Tile*)));
+}
+
+Autosave::~Autosave()
+{
+    // regular shutdown, nothing to recover
+    if(started_)
+        QMetaObject::invokeMethod(writer_, "discard", Qt::BlockingQueuedConnection);
+
+    thread_.quit();
+    thread_.wait();
+}
+
+bool Autosave::hasRecovery() const
+{
+    return QFile::exists(getSnapshotPath()) || QFile::exists(getJournalPath());
+}
+
+const QJsonObject Autosave::recover() const
+{
+    QJsonObject project;
+    if(QFile::exists(getSnapshotPath()) && !ProjectFile::read(getSnapshotPath(), &project)) {
+        qDebug() << "FAILURE: Could not read autosave snapshot";
+        qDebug() << " > File:" << getSnapshotPath();
+        project = QJsonObject();
+    }
+
+    QJsonObject scene_obj = project.value("scene").toObject();
+    if(!scene_obj.contains("scene_rect")) {
+        QJsonObject scene_rect_obj;
+        scene_rect_obj["x"] = view_->sceneRect().x();
+        scene_rect_obj["y"] = view_->sceneRect().y();
+        scene_rect_obj["width"] = view_->sceneRect().width();
+        scene_rect_obj["height"] = view_->sceneRect().height();
+        scene_obj["scene_rect"] = scene_rect_obj;
+    }
+
+    // tiles of snapshot by uuid, kept in order of snapshot
+    QStringList order;
+    QHash<QString, QJsonObject> tiles;
+    foreach(QJsonValue const& val, scene_obj.value("tiles").toArray()) {
+        QJsonObject tile = val.toObject();
+        QString uuid = tile.value("data").toObject().value("uuid").toString();
+        if(uuid.isEmpty())
+            continue;
+        order.append(uuid);
+        tiles.insert(uuid, tile);
+    }
+
+    // apply journal
+    int applied = 0;
+    QFile journal(getJournalPath());
+    if(journal.open(QFile::ReadOnly)) {
+        while(!journal.atEnd()) {
+            QByteArray line = journal.readLine().trimmed();
+            if(line.isEmpty())
+                continue;
+
+            // last entry is torn, if program crashed while writing it
+            QJsonParseError error;
+            QJsonObject entry = QJsonDocument::fromJson(line, &error).object();
+            if(error.error != QJsonParseError::NoError) {
+                qDebug() << "NOTIFICATION: Skipped malformed autosave journal entry";
+                qDebug() << " > Error:" << error.errorString();
+                break;
+            }
+
+            QString op = entry["op"].toString();
+            QString uuid = entry["uuid"].toString();
+            if(op == "add") {
+                if(!tiles.contains(uuid))
+                    order.append(uuid);
+                QJsonObject tile;
+                tile["type"] = entry["type"];
+                tile["data"] = entry["data"];
+                tiles.insert(uuid, tile);
+            } else if(op == "remove") {
+                order.removeOne(uuid);
+                tiles.remove(uuid);
+            } else if(tiles.contains(uuid)) {
+                // changed properties only, removed ones are null
+                QJsonObject data = tiles[uuid].value("data").toObject();
+                QJsonObject changes = entry.value("data").toObject();
+                foreach(QString const& key, changes.keys()) {
+                    if(changes.value(key).isNull())
+                        data.remove(key);
+                    else
+                        data[key] = changes.value(key);
+                }
+                tiles[uuid]["data"] = data;
+            }
+            ++applied;
+        }
+    }
+
+    QJsonArray arr_tiles;
+    foreach(QString const& uuid, order)
+        arr_tiles.append(tiles[uuid]);
+    scene_obj["tiles"] = arr_tiles;
+    project["scene"] = scene_obj;
+
+    qDebug() << "NOTIFICATION: Recovered autosave";
+    qDebug() << " > tiles:" << arr_tiles.size() << "journal entries:" << applied;
+
+    return project;
+}
+
+void Autosave::start()
+{
+    started_ = true;
+    snapshot();
+    compact_timer_->start();
+}
+
+void Autosave::snapshot()
+{
+    if(!started_)
+        return;
+
+    flush_timer_->stop();
+
+    QJsonObject project = view_->toJsonObject();
+    project["random_seed"] = (double) RandomService::instance()->getSeed();
+
+    // snapshot holds all changes, journaled state starts from it
+    QHash<QString, QJsonObject> tiles;
+    foreach(QJsonValue const& val, project.value("scene").toObject().value("tiles").toArray()) {
+        QJsonObject data = val.toObject().value("data").toObject();
+        tiles.insert(data.value("uuid").toString(), data);
+    }
+    QHash<TwoD::Tile*, QJsonObject>::iterator it = states_.begin();
+    for(; it != states_.end(); ++it)
+        it.value() = tiles.value(it.key()->getUuid().toString());
+
+    modified_.clear();
+    entries_since_snapshot_ = 0;
+
+    emit snapshotRequested(project);
+}
+
+void Autosave::compact()
+{
+    if(entries_since_snapshot_ > 0 || !modified_.isEmpty())
+        snapshot();
+}
+
+void Autosave::onTileAdded(TwoD::Tile *tile)
+{
+    if(states_.contains(tile))
+        return;
+
+    states_.insert(tile, QJsonObject());
+    connect(tile, SIGNAL(changed()),
+            this, SLOT(onTileChanged()));
+    connect(tile, SIGNAL(destroyed(QObject*)),
+            this, SLOT(onTileDestroyed(QObject*)));
+
+    modified_.insert(tile);
+    if(started_ && !flush_timer_->isActive())
+        flush_timer_->start();
+}
+
+void Autosave::onTileChanged()
+{
+    TwoD::Tile* tile = qobject_cast<TwoD::Tile*>(sender());
+    if(tile == 0)
+        return;
+
+    modified_.insert(tile);
+
+    // not restarted on each change, so continuous changes still get saved
+    if(started_ && !flush_timer_->isActive())
+        flush_timer_->start();
+}
+
+void Autosave::onTileDestroyed(QObject *obj)
+{
+    // tile is destroyed, pointer is a key only
+    TwoD::Tile* tile = static_cast<TwoD::Tile*>(obj);
+    QJsonObject state = states_.take(tile);
+    modified_.remove(tile);
+
+    // tiles never journaled are not in journal or snapshot
+    if(!started_ || state.isEmpty())
+        return;
+
+    QJsonObject entry;
+    entry["op"] = QString("remove");
+    entry["uuid"] = state["uuid"];
+    appendEntry(entry);
+}
+
+void Autosave::flush()
+{
+    if(!started_)
+        return;
+
+    QSet<TwoD::Tile*> later;
+    foreach(TwoD::Tile* tile, modified_) {
+        // tiles which are not in the scene yet get journaled later
+        if(tile->scene() == 0) {
+            later.insert(tile);
+            continue;
+        }
+
+        QJsonObject& state = states_[tile];
+        QJsonObject current = tile->toJsonObject();
+
+        QJsonObject entry;
+        if(state.isEmpty()) {
+            entry["op"] = QString("add");
+            entry["uuid"] = current["uuid"];
+            entry["type"] = QString(tile->metaObject()->className());
+            entry["data"] = current;
+        } else {
+            // changed and removed properties
+            QJsonObject changes;
+            foreach(QString const& key, current.keys()) {
+                if(state.value(key) != current.value(key))
+                    changes[key] = current[key];
+            }
+            foreach(QString const& key, state.keys()) {
+                if(!current.contains(key))
+                    changes[key] = QJsonValue();
+            }
+            if(changes.isEmpty())
+                continue;
+
+            // op names the change, if it is a single one
+            QString op = "update";
+            if(changes.size() == 1) {
+                QString key = changes.keys().first();
+                if(key == "position")
+                    op = "move";
+                else if(key == "size")
+                    op = "resize";
+                else if(key == "activate_key")
+                    op = "key";
+                else if(key == "settings" || key == "playlist" || key == "name")
+                    op = key;
+            }
+
+            entry["op"] = op;
+            entry["uuid"] = current["uuid"];
+            entry["data"] = changes;
+        }
+
+        state = current;
+        appendEntry(entry);
+    }
+    modified_ = later;
+}
+
+void Autosave::appendEntry(const QJsonObject &entry)
+{
+    emit appendRequested(QJsonDocument(entry).toJson(QJsonDocument::Compact) + '\n');
+
+    if(++entries_since_snapshot_ >= AUTOSAVE_MAX_ENTRIES)
+        QMetaObject::invokeMethod(this, "compact", Qt::QueuedConnection);
+}
+
+QString Autosave::getJournalPath() const
+{
+    return QDir(dir_).filePath(AUTOSAVE_JOURNAL_FILE);
+}
+
+QString Autosave::getSnapshotPath() const
+{
+    return QDir(dir_).filePath(AUTOSAVE_SNAPSHOT_FILE);
+}
+
+} // namespace Misc
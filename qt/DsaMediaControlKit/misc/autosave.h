@@ -0,0 +1,117 @@
+#ifndef MISC_AUTOSAVE_H
+#define MISC_AUTOSAVE_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QFile>
+#include <QHash>
+#include <QSet>
+#include <QJsonObject>
+
+#include "2D/graphics_view.h"
+
+namespace Misc {
+
+/*
+ * Writes autosave files, lives in the autosave thread.
+ * Journal entries are appended and flushed as they arrive.
+ * A snapshot replaces the previous one atomically, then the journal is emptied.
+*/
+class AutosaveWriter : public QObject
+{
+    Q_OBJECT
+public:
+    AutosaveWriter(QString const& dir);
+
+public slots:
+    void append(QByteArray const& lines);
+    void writeSnapshot(QJsonObject const& project);
+
+    /* closes and removes all autosave files */
+    void discard();
+
+private:
+    QString dir_;
+    QFile journal_;
+};
+
+/*
+ * Autosave of the board shown in a GraphicsView.
+ * Mutations of tiles (add, remove, move, resize, key binding, name,
+ * playlist and settings) get recorded into an append-only journal.
+ * Changes are collected for a short time, so a drag or animation results
+ * in a single entry per tile, holding only the changed properties.
+ * The journal is compacted into a snapshot (binary project, see ProjectFile)
+ * periodically and after a number of entries.
+ * All file I/O happens in a separate thread, the GUI thread only builds entries.
+ * Files are removed on regular shutdown, so they only remain after a crash.
+*/
+class Autosave : public QObject
+{
+    Q_OBJECT
+public:
+    /* Tracks tiles of view, files are stored in Resources::AUTOSAVE_DIR */
+    Autosave(TwoD::GraphicsView* view, QObject* parent = 0);
+    ~Autosave();
+
+    /* Returns true if files of an unfinished session exist */
+    bool hasRecovery() const;
+
+    /*
+     * Returns project of unfinished session (snapshot with journal applied).
+     * A torn last journal entry (crash while writing) is skipped.
+    */
+    const QJsonObject recover() const;
+
+    /*
+     * Starts recording, replaces files of previous session
+     * with snapshot of current board.
+    */
+    void start();
+
+public slots:
+    /* Compacts journal into snapshot of current board */
+    void snapshot();
+
+private slots:
+    /* snapshot, if there are changes since the last one */
+    void compact();
+
+    void onTileAdded(TwoD::Tile* tile);
+    void onTileChanged();
+    void onTileDestroyed(QObject* obj);
+
+    /* journals changes of all modified tiles */
+    void flush();
+
+signals:
+    void appendRequested(QByteArray const& lines);
+    void snapshotRequested(QJsonObject const& project);
+
+private:
+    void appendEntry(QJsonObject const& entry);
+
+    QString getJournalPath() const;
+    QString getSnapshotPath() const;
+
+    TwoD::GraphicsView* view_;
+    QString dir_;
+    bool started_;
+
+    // last journaled state of each tile (empty until first journaled)
+    QHash<TwoD::Tile*, QJsonObject> states_;
+    QSet<TwoD::Tile*> modified_;
+
+    int entries_since_snapshot_;
+
+    QTimer* flush_timer_;
+    QTimer* compact_timer_;
+
+    QThread thread_;
+    AutosaveWriter* writer_;
+};
+
+} // namespace Misc
+
+#endif // MISC_AUTOSAVE_H
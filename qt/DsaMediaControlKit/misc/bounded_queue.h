@@ -0,0 +1,115 @@
+#ifndef MISC_BOUNDED_QUEUE_H
+#define MISC_BOUNDED_QUEUE_H
+
+#include <QQueue>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+
+namespace Misc {
+
+/*
+ * Thread safe FIFO queue with a fixed capacity.
+ * Used to join worker threads of a pipeline.
+ * push() blocks while the queue is full,
+ * pop() blocks while the queue is empty.
+ * close() signals that no more values will be pushed,
+ * cancel() discards all values and wakes up all waiting threads.
+*/
+template<typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(int capacity)
+        : queue_()
+        , capacity_(capacity > 0 ? capacity : 1)
+        , closed_(false)
+        , cancelled_(false)
+        , mutex_()
+        , not_empty_()
+        , not_full_()
+    {}
+
+    /*
+     * Appends value to the queue.
+     * Blocks until there is space available.
+     * Returns false if queue has been closed or cancelled.
+    */
+    bool push(T const& value)
+    {
+        QMutexLocker locker(&mutex_);
+        while(queue_.size() >= capacity_ && !closed_ && !cancelled_)
+            not_full_.wait(&mutex_);
+
+        if(closed_ || cancelled_)
+            return false;
+
+        queue_.enqueue(value);
+        not_empty_.wakeOne();
+        return true;
+    }
+
+    /*
+     * Takes first value from the queue.
+     * Blocks until a value is available.
+     * Returns false if queue has been cancelled,
+     * or if it has been closed and all values have been taken.
+    */
+    bool pop(T& value)
+    {
+        QMutexLocker locker(&mutex_);
+        while(queue_.isEmpty() && !closed_ && !cancelled_)
+            not_empty_.wait(&mutex_);
+
+        if(cancelled_ || queue_.isEmpty())
+            return false;
+
+        value = queue_.dequeue();
+        not_full_.wakeOne();
+        return true;
+    }
+
+    /* No more values will be pushed, waiting consumers drain the queue. */
+    void close()
+    {
+        QMutexLocker locker(&mutex_);
+        closed_ = true;
+        not_empty_.wakeAll();
+        not_full_.wakeAll();
+    }
+
+    /* Discards all values, waiting producers and consumers return false. */
+    void cancel()
+    {
+        QMutexLocker locker(&mutex_);
+        cancelled_ = true;
+        queue_.clear();
+        not_empty_.wakeAll();
+        not_full_.wakeAll();
+    }
+
+    bool isCancelled() const
+    {
+        QMutexLocker locker(&mutex_);
+        return cancelled_;
+    }
+
+    int size() const
+    {
+        QMutexLocker locker(&mutex_);
+        return queue_.size();
+    }
+
+private:
+    QQueue<T> queue_;
+    int capacity_;
+    bool closed_;
+    bool cancelled_;
+    mutable QMutex mutex_;
+    QWaitCondition not_empty_;
+    QWaitCondition not_full_;
+};
+
+} // namespace Misc
+
+#endif // MISC_BOUNDED_QUEUE_H
@@ -1,6 +1,5 @@
 #include "json_mime_data_parser.h"
 
-#include <QJsonArray>
 #include <QDebug>
 
 namespace Misc {
@@ -99,20 +98,9 @@ DB::TableRecord *JsonMimeDataParser::toTableRecord(const QJsonObject& obj)
         return rec;
 
     if(obj["type"] == DB::SOUND_FILE) {
-        int id = -1;
-        QString name = "";
-        QString path = "";
-        QString relative_path = "";
-        if(obj.contains("id"))
-            id = obj["id"].toInt();
-        if(obj.contains("name") || obj["name"].isString())
-            name = obj["name"].toString();
-        if(obj.contains("path") || obj["path"].isString())
-            path = obj["path"].toString();
-        if(obj.contains("relative_path") || obj["relative_path"].isString())
-            relative_path = obj["relative_path"].toString();
-
-        rec = new DB::SoundFileRecord(id, name, path, relative_path);
+        DB::SoundFileRecord* sound_rec = new DB::SoundFileRecord;
+        toSoundFileRecord(obj, sound_rec);
+        rec = sound_rec;
     }
     else if(obj["type"] == DB::CATEGORY) {
         int id = -1;
@@ -131,6 +119,73 @@ DB::TableRecord *JsonMimeDataParser::toTableRecord(const QJsonObject& obj)
     return rec;
 }
 
+bool JsonMimeDataParser::toSoundFileRecord(const QJsonObject &obj, DB::SoundFileRecord *rec)
+{
+    // one lookup per attribute
+    if(obj.value("type").toInt(DB::NONE) != DB::SOUND_FILE)
+        return false;
+
+    rec->id = obj.value("id").toInt(-1);
+    rec->name = obj.value("name").toString();
+    rec->path = obj.value("path").toString();
+    rec->relative_path = obj.value("relative_path").toString();
+
+    return true;
+}
+
+QVector<DB::SoundFileRecord> JsonMimeDataParser::toSoundFileRecords(const QJsonArray &arr)
+{
+    // records are read in place, the vector never grows
+    QVector<DB::SoundFileRecord> records(arr.size());
+    int count = 0;
+    foreach(QJsonValue const& val, arr) {
+        if(toSoundFileRecord(val.toObject(), &records[count]))
+            ++count;
+    }
+    records.resize(count);
+
+    return records;
+}
+
+QVector<DB::SoundFileRecord> JsonMimeDataParser::toSoundFileRecords(const QMimeData *mime)
+{
+    QVector<DB::SoundFileRecord> records;
+    if(mime == 0 || !mime->hasText())
+        return records;
+
+    QJsonDocument doc = QJsonDocument::fromJson(mime->text().toUtf8());
+    if(doc.isArray())
+        return toSoundFileRecords(doc.array());
+
+    if(doc.isObject()) {
+        DB::SoundFileRecord rec;
+        if(toSoundFileRecord(doc.object(), &rec))
+            records.append(rec);
+    }
+
+    return records;
+}
+
+QMimeData *JsonMimeDataParser::toJsonMimeData(const QVector<DB::SoundFileRecord> &records)
+{
+    if(records.size() == 0)
+        return 0;
+
+    QMimeData* data = new QMimeData;
+    data->setText(QString(QJsonDocument(toJsonArray(records)).toJson()));
+
+    return data;
+}
+
+const QJsonArray JsonMimeDataParser::toJsonArray(const QVector<DB::SoundFileRecord> &records)
+{
+    QJsonArray arr;
+    foreach(DB::SoundFileRecord const& rec, records)
+        arr.append(toJsonObject(rec));
+
+    return arr;
+}
+
 const QJsonObject JsonMimeDataParser::toJsonObject(DB::TableRecord* rec)
 {
     QJsonObject obj;
@@ -158,16 +213,22 @@ const QJsonObject JsonMimeDataParser::toJsonObject(DB::TableRecord* rec)
 
 const QJsonObject JsonMimeDataParser::toJsonObject(DB::SoundFileRecord* rec)
 {
-    QJsonObject obj;
-
     if(rec == 0)
-        return obj;
+        return QJsonObject();
 
-    obj.insert("type", QJsonValue(rec->index));
-    obj.insert("id", QJsonValue(rec->id));
-    obj.insert("name", QJsonValue(rec->name));
-    obj.insert("path", QJsonValue(rec->path));
-    obj.insert("relative_path", QJsonValue(rec->relative_path));
+    return toJsonObject(*rec);
+}
+
+const QJsonObject JsonMimeDataParser::toJsonObject(const DB::SoundFileRecord &rec)
+{
+    QJsonObject obj;
+
+    // keys are kept sorted, inserting in key order appends without moving entries
+    obj.insert("id", QJsonValue(rec.id));
+    obj.insert("name", QJsonValue(rec.name));
+    obj.insert("path", QJsonValue(rec.path));
+    obj.insert("relative_path", QJsonValue(rec.relative_path));
+    obj.insert("type", QJsonValue(rec.index));
 
     return obj;
 }
@@ -186,6 +247,10 @@ const QJsonObject JsonMimeDataParser::toJsonObject(Playlist::Settings* settings)
     obj.insert("min_interval_val", QJsonValue(settings->min_delay_interval));
     obj.insert("max_interval_val", QJsonValue(settings->max_delay_interval));
     obj.insert("volume", QJsonValue(settings->volume));
+    obj.insert("weighted_mode", QJsonValue(settings->weighted_mode));
+    obj.insert("no_repeat_count", QJsonValue(settings->no_repeat_count));
+    obj.insert("crossfade_flag", QJsonValue(settings->crossfade_flag));
+    obj.insert("crossfade_duration", QJsonValue(settings->crossfade_duration));
 
     return obj;
 
@@ -241,6 +306,24 @@ Playlist::Settings* JsonMimeDataParser::toPlaylistSettings(const QJsonObject& ob
         set->order = Playlist::WEIGTHED;
     }
 
+    // set weighted mode (optional, missing in older projects)
+    if(obj["weighted_mode"] == 1) {
+        set->weighted_mode = Playlist::WEIGHTED_NO_REPEAT;
+    } else if(obj["weighted_mode"] == 2) {
+        set->weighted_mode = Playlist::WEIGHTED_SHUFFLE_BAG;
+    }
+    if(obj["no_repeat_count"].toInt() > 0) {
+        set->no_repeat_count = obj["no_repeat_count"].toInt();
+    }
+
+    // set crossfade (optional, missing in older projects)
+    if(obj["crossfade_flag"] == true) {
+        set->crossfade_flag = true;
+    }
+    if(obj["crossfade_duration"].toInt() > 0) {
+        set->crossfade_duration = qBound(CROSSFADE_MIN_DURATION, obj["crossfade_duration"].toInt(), CROSSFADE_MAX_DURATION);
+    }
+
     return set;
 }
 
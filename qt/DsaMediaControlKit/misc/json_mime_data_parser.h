@@ -4,7 +4,9 @@
 #include <QJsonDocument>
 #include <QMimeData>
 #include <QJsonObject>
+#include <QJsonArray>
 #include <QList>
+#include <QVector>
 
 #include "db/table_records.h"
 #include "playlist/settings.h"
@@ -16,6 +18,13 @@ namespace Misc {
 * TableRecords will be referenced by a Json serialized string,
 * inside the text() property of QMimeData.
 * Also transfers QMimeData back to TableRecord.
+*
+* Sound files can be converted as values (see toSoundFileRecords(...)),
+* bulk conversions store all records in one block, nothing to delete after use.
+* Strings are not pooled: QJsonValue::toString() allocates a new string
+* for every attribute, so each parsed sound file costs three string
+* allocations (name, path, relative_path), which the record then owns.
+* --record-benchmark reports how much of the parse time they take.
 */
 
 class JsonMimeDataParser
@@ -68,11 +77,41 @@ public:
     */
     static DB::TableRecord* toTableRecord(const QJsonObject&);
 
+    /*
+     * Reads sound file from given QJsonObject into rec.
+     * Returns false if obj does not describe a sound file.
+    */
+    static bool toSoundFileRecord(const QJsonObject& obj, DB::SoundFileRecord* rec);
+
+    /*
+     * Extracts all sound files of given QJsonArray.
+     * Records are stored by value, allocated once for the whole array
+     * (strings of each record are allocated separately).
+    */
+    static QVector<DB::SoundFileRecord> toSoundFileRecords(const QJsonArray&);
+
+    /*
+     * Extracts all sound files of given QMimeData.
+     * (see toJsonMimeData(...))
+    */
+    static QVector<DB::SoundFileRecord> toSoundFileRecords(const QMimeData*);
+
+    /*
+     * creates QMimeData with text set to a string
+     * wrapping a json serialized array of given sound files.
+     * returns 0 if records are empty.
+    */
+    static QMimeData* toJsonMimeData(const QVector<DB::SoundFileRecord>&);
+
+    /* Creates JsonArray from given sound files */
+    static const QJsonArray toJsonArray(const QVector<DB::SoundFileRecord>&);
+
     /* Creates JsonObject from given DB::TableRecord */
     static const QJsonObject toJsonObject(DB::TableRecord*);
 
     /* Creates JsonObject from given DB::SoundFileRecord */
     static const QJsonObject toJsonObject(DB::SoundFileRecord*);
+    static const QJsonObject toJsonObject(DB::SoundFileRecord const&);
 
     /* Creates JsonObject from given Playlist::Settings */
     static const QJsonObject toJsonObject(Playlist::Settings*);
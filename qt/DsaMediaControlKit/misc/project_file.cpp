@@ -0,0 +1,308 @@
+#include "project_file.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <cmath>
+
+// first bytes of a binary project file, written as they are
+#define PROJECT_MAGIC "DSAP"
+#define PROJECT_MAGIC_SIZE 4
+#define PROJECT_VERSION 1
+// nesting of values accepted on read (projects nest 5 levels deep)
+#define PROJECT_MAX_DEPTH 64
+
+namespace Misc {
+
+bool ProjectFile::isBinary(const QString &path)
+{
+    return path.endsWith(PROJECT_BINARY_SUFFIX, Qt::CaseInsensitive);
+}
+
+bool ProjectFile::read(const QString &path, QJsonObject *obj)
+{
+    QFile file(path);
+    if(!file.open(QFile::ReadOnly)) {
+        qDebug() << "FAILURE: Could not open project file";
+        qDebug() << " > File:" << path;
+        return false;
+    }
+
+    if(isBinary(path))
+        return readBinary(&file, obj);
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if(doc.isNull() || !doc.isObject()) {
+        qDebug() << "FAILURE: Could not parse JSON project file";
+        qDebug() << " > File:" << path;
+        qDebug() << " > Error:" << error.errorString();
+        return false;
+    }
+
+    *obj = doc.object();
+    return true;
+}
+
+bool ProjectFile::write(const QString &path, const QJsonObject &obj)
+{
+    // previous file stays intact, until new one is complete
+    QSaveFile file(path);
+    if(!file.open(QFile::WriteOnly)) {
+        qDebug() << "FAILURE: Could not open project file for writing";
+        qDebug() << " > File:" << path;
+        return false;
+    }
+
+    if(isBinary(path)) {
+        if(!writeBinary(&file, obj)) {
+            file.cancelWriting();
+            return false;
+        }
+    } else {
+        file.write(QJsonDocument(obj).toJson());
+    }
+
+    return file.commit();
+}
+
+bool ProjectFile::readBinary(QIODevice *device, QJsonObject *obj)
+{
+    QDataStream in(device);
+    in.setByteOrder(QDataStream::LittleEndian);
+
+    char magic[PROJECT_MAGIC_SIZE];
+    quint16 version = 0;
+    if(in.readRawData(magic, PROJECT_MAGIC_SIZE) != PROJECT_MAGIC_SIZE)
+        in.setStatus(QDataStream::ReadPastEnd);
+    in >> version;
+    if(in.status() != QDataStream::Ok || qstrncmp(magic, PROJECT_MAGIC, PROJECT_MAGIC_SIZE) != 0 || version > PROJECT_VERSION) {
+        qDebug() << "FAILURE: Not a binary project file or unsupported version";
+        qDebug() << " > Version:" << version;
+        return false;
+    }
+
+    // string table
+    quint64 count = readVarUInt(in);
+    QStringList table;
+    for(quint64 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        quint64 size = readVarUInt(in);
+        QByteArray utf8((int) qMin(size, (quint64) device->bytesAvailable()), Qt::Uninitialized);
+        if((quint64) utf8.size() != size || in.readRawData(utf8.data(), utf8.size()) != utf8.size()) {
+            in.setStatus(QDataStream::ReadPastEnd);
+            break;
+        }
+        table.append(QString::fromUtf8(utf8));
+    }
+
+    QJsonValue val;
+    if(in.status() != QDataStream::Ok || !readValue(in, table, &val, 0) || !val.isObject()) {
+        qDebug() << "FAILURE: Binary project file is corrupt";
+        return false;
+    }
+
+    *obj = val.toObject();
+    return true;
+}
+
+bool ProjectFile::writeBinary(QIODevice *device, const QJsonObject &obj)
+{
+    QHash<QString, quint32> indexes;
+    QStringList table;
+    collectStrings(obj, &indexes, &table);
+
+    QDataStream out(device);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.writeRawData(PROJECT_MAGIC, PROJECT_MAGIC_SIZE);
+    out << (quint16) PROJECT_VERSION;
+
+    writeVarUInt(out, table.size());
+    foreach(QString const& str, table) {
+        QByteArray utf8 = str.toUtf8();
+        writeVarUInt(out, utf8.size());
+        out.writeRawData(utf8.constData(), utf8.size());
+    }
+
+    writeValue(out, obj, indexes);
+
+    if(out.status() != QDataStream::Ok) {
+        qDebug() << "FAILURE: Could not write binary project file";
+        return false;
+    }
+    return true;
+}
+
+void ProjectFile::collectStrings(const QJsonValue &val, QHash<QString, quint32> *indexes, QStringList *table)
+{
+    if(val.isString()) {
+        if(!indexes->contains(val.toString())) {
+            indexes->insert(val.toString(), table->size());
+            table->append(val.toString());
+        }
+    } else if(val.isArray()) {
+        foreach(QJsonValue const& v, val.toArray())
+            collectStrings(v, indexes, table);
+    } else if(val.isObject()) {
+        QJsonObject obj = val.toObject();
+        for(QJsonObject::const_iterator it = obj.constBegin(); it != obj.constEnd(); ++it) {
+            collectStrings(it.key(), indexes, table);
+            collectStrings(it.value(), indexes, table);
+        }
+    }
+}
+
+void ProjectFile::writeValue(QDataStream &out, const QJsonValue &val, const QHash<QString, quint32> &indexes)
+{
+    switch(val.type()) {
+        case QJsonValue::Bool:
+            out << (quint8) (val.toBool() ? TAG_TRUE : TAG_FALSE);
+            break;
+
+        case QJsonValue::Double: {
+            // integral values (positions, ids, settings) as zigzag variable length integer
+            double d = val.toDouble();
+            if(d == std::floor(d) && std::fabs(d) < 9007199254740992.0 && !(d == 0 && std::signbit(d))) {
+                qint64 i = (qint64) d;
+                out << (quint8) TAG_INT;
+                writeVarUInt(out, ((quint64) i << 1) ^ (quint64) (i >> 63));
+            } else {
+                out << (quint8) TAG_DOUBLE << d;
+            }
+            break;
+        }
+
+        case QJsonValue::String:
+            out << (quint8) TAG_STRING;
+            writeVarUInt(out, indexes.value(val.toString()));
+            break;
+
+        case QJsonValue::Array: {
+            QJsonArray arr = val.toArray();
+            out << (quint8) TAG_ARRAY;
+            writeVarUInt(out, arr.size());
+            foreach(QJsonValue const& v, arr)
+                writeValue(out, v, indexes);
+            break;
+        }
+
+        case QJsonValue::Object: {
+            QJsonObject obj = val.toObject();
+            out << (quint8) TAG_OBJECT;
+            writeVarUInt(out, obj.size());
+            for(QJsonObject::const_iterator it = obj.constBegin(); it != obj.constEnd(); ++it) {
+                writeVarUInt(out, indexes.value(it.key()));
+                writeValue(out, it.value(), indexes);
+            }
+            break;
+        }
+
+        default:
+            out << (quint8) TAG_NULL;
+            break;
+    }
+}
+
+bool ProjectFile::readValue(QDataStream &in, const QStringList &table, QJsonValue *val, int depth)
+{
+    if(depth > PROJECT_MAX_DEPTH)
+        return false;
+
+    quint8 tag = TAG_NULL;
+    in >> tag;
+
+    switch(tag) {
+        case TAG_NULL:
+            *val = QJsonValue();
+            break;
+
+        case TAG_FALSE:
+        case TAG_TRUE:
+            *val = QJsonValue(tag == TAG_TRUE);
+            break;
+
+        case TAG_INT: {
+            quint64 z = readVarUInt(in);
+            qint64 i = (qint64) (z >> 1) ^ -((qint64) (z & 1));
+            *val = QJsonValue((double) i);
+            break;
+        }
+
+        case TAG_DOUBLE: {
+            double d = 0;
+            in >> d;
+            *val = QJsonValue(d);
+            break;
+        }
+
+        case TAG_STRING: {
+            quint64 index = readVarUInt(in);
+            if(index >= (quint64) table.size())
+                return false;
+            *val = QJsonValue(table[(int) index]);
+            break;
+        }
+
+        case TAG_ARRAY: {
+            quint64 count = readVarUInt(in);
+            QJsonArray arr;
+            for(quint64 i = 0; i < count; ++i) {
+                QJsonValue v;
+                if(!readValue(in, table, &v, depth + 1))
+                    return false;
+                arr.append(v);
+            }
+            *val = arr;
+            break;
+        }
+
+        case TAG_OBJECT: {
+            quint64 count = readVarUInt(in);
+            QJsonObject obj;
+            for(quint64 i = 0; i < count; ++i) {
+                quint64 key = readVarUInt(in);
+                QJsonValue v;
+                if(key >= (quint64) table.size() || !readValue(in, table, &v, depth + 1))
+                    return false;
+                obj.insert(table[(int) key], v);
+            }
+            *val = obj;
+            break;
+        }
+
+        default:
+            return false;
+    }
+
+    return in.status() == QDataStream::Ok;
+}
+
+void ProjectFile::writeVarUInt(QDataStream &out, quint64 val)
+{
+    // 7 bits per byte, high bit set if more bytes follow
+    while(val >= 0x80) {
+        out << (quint8) ((val & 0x7f) | 0x80);
+        val >>= 7;
+    }
+    out << (quint8) val;
+}
+
+quint64 ProjectFile::readVarUInt(QDataStream &in)
+{
+    quint64 val = 0;
+    for(int shift = 0; shift < 64; shift += 7) {
+        quint8 byte = 0;
+        in >> byte;
+        if(in.status() != QDataStream::Ok)
+            return 0;
+        val |= (quint64) (byte & 0x7f) << shift;
+        if((byte & 0x80) == 0)
+            return val;
+    }
+
+    in.setStatus(QDataStream::ReadCorruptData);
+    return 0;
+}
+
+} // namespace Misc
@@ -0,0 +1,85 @@
+#ifndef MISC_PROJECT_FILE_H
+#define MISC_PROJECT_FILE_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QDataStream>
+#include <QIODevice>
+
+// extension of binary project files
+#define PROJECT_BINARY_SUFFIX ".dsap"
+
+namespace Misc {
+
+/*
+* Reads and writes project files.
+* Projects ending with PROJECT_BINARY_SUFFIX are stored in a compact binary format,
+* all others as JSON text.
+*
+* The binary format encodes the JSON value tree of a project losslessly,
+* so both formats convert into each other without change:
+*   header:       magic bytes "DSAP", format version (quint16)
+*   string table: count, then each string as UTF-8 (length, bytes)
+*   value tree:   type tag, followed by the value
+*                 (strings and object keys as index into the string table).
+* Each path, name and key is stored once, however often tiles reference it.
+* Counts, indexes and integral numbers are stored as variable length integers.
+* Bytes are read and written through a stream, without a buffer of the whole file,
+* but the project itself is always held as a complete QJsonObject:
+* saving builds the JSON tree of the whole scene first, loading builds it
+* before the scene is restored from it.
+*/
+class ProjectFile
+{
+public:
+    /* Returns true if file at path is stored in binary format (by extension) */
+    static bool isBinary(QString const& path);
+
+    /*
+     * Reads project from file into obj, format selected by extension.
+     * Returns success.
+    */
+    static bool read(QString const& path, QJsonObject* obj);
+
+    /*
+     * Writes project obj to file, format selected by extension.
+     * Returns success.
+    */
+    static bool write(QString const& path, QJsonObject const& obj);
+
+    /* Reads binary project from device, returns success */
+    static bool readBinary(QIODevice* device, QJsonObject* obj);
+
+    /* Writes binary project to device, returns success */
+    static bool writeBinary(QIODevice* device, QJsonObject const& obj);
+
+private:
+    enum ValueTag {
+        TAG_NULL,
+        TAG_FALSE,
+        TAG_TRUE,
+        TAG_INT,
+        TAG_DOUBLE,
+        TAG_STRING,
+        TAG_ARRAY,
+        TAG_OBJECT
+    };
+
+    /* adds all strings and keys of value to table */
+    static void collectStrings(QJsonValue const& val, QHash<QString, quint32>* indexes, QStringList* table);
+
+    static void writeValue(QDataStream& out, QJsonValue const& val, QHash<QString, quint32> const& indexes);
+
+    /* returns false on malformed data */
+    static bool readValue(QDataStream& in, QStringList const& table, QJsonValue* val, int depth);
+
+    static void writeVarUInt(QDataStream& out, quint64 val);
+    static quint64 readVarUInt(QDataStream& in);
+};
+
+} // namespace Misc
+
+#endif // MISC_PROJECT_FILE_H
@@ -0,0 +1,165 @@
+#include "random_service.h"
+
+#include <QDebug>
+#include <QJsonArray>
+
+namespace Misc {
+
+RandomService *RandomService::instance()
+{
+    static RandomService service;
+    return &service;
+}
+
+void RandomService::setSeed(quint32 seed)
+{
+    seed_ = seed;
+    engines_.clear();
+}
+
+quint32 RandomService::getSeed() const
+{
+    return seed_;
+}
+
+quint32 RandomService::generateSeed()
+{
+    std::random_device rd;
+    return rd();
+}
+
+std::mt19937 &RandomService::getEngine(const QString &stream)
+{
+    QHash<QString, std::mt19937>::iterator it = engines_.find(stream);
+    if(it == engines_.end()) {
+        std::seed_seq seq{seed_, hashStream(stream)};
+        it = engines_.insert(stream, std::mt19937(seq));
+    }
+
+    return it.value();
+}
+
+int RandomService::getInt(const QString &stream, int min, int max)
+{
+    if(max < min)
+        return min;
+
+    // replayed values outside of range stem from changed settings
+    int value = 0;
+    if(takeReplayValue(stream, &value) && value >= min && value <= max)
+        return record(stream, value);
+
+    std::uniform_int_distribution<int> uni(min, max);
+    return record(stream, uni(getEngine(stream)));
+}
+
+bool RandomService::takeReplayValue(const QString &stream, int *value)
+{
+    if(!replaying_)
+        return false;
+
+    QHash<QString, QList<int> >::iterator it = replay_.find(stream);
+    if(it == replay_.end() || it.value().isEmpty())
+        return false;
+
+    *value = it.value().takeFirst();
+    return true;
+}
+
+int RandomService::record(const QString &stream, int value)
+{
+    if(recording_)
+        recorded_[stream].append(value);
+    return value;
+}
+
+void RandomService::startRecording()
+{
+    // streams restart, so replay continues like the recorded session after its last value
+    setSeed(seed_);
+    recorded_.clear();
+    recording_ = true;
+}
+
+void RandomService::stopRecording()
+{
+    recording_ = false;
+}
+
+bool RandomService::isRecording() const
+{
+    return recording_;
+}
+
+const QJsonObject RandomService::getRecording() const
+{
+    QJsonObject streams;
+    QHash<QString, QList<int> >::const_iterator it = recorded_.constBegin();
+    for(; it != recorded_.constEnd(); ++it) {
+        QJsonArray values;
+        foreach(int value, it.value())
+            values.append(value);
+        streams[it.key()] = values;
+    }
+
+    QJsonObject obj;
+    obj["seed"] = (double) seed_;
+    obj["streams"] = streams;
+
+    return obj;
+}
+
+bool RandomService::startReplay(const QJsonObject &recording)
+{
+    if(!recording.contains("seed") || !recording["streams"].isObject()) {
+        qDebug() << "FAILURE: Could not parse session recording";
+        qDebug() << " > Missing attribute description.";
+        return false;
+    }
+
+    replay_.clear();
+    QJsonObject streams = recording["streams"].toObject();
+    foreach(QString const& stream, streams.keys()) {
+        QList<int>& values = replay_[stream];
+        foreach(QJsonValue val, streams[stream].toArray())
+            values.append(val.toInt());
+    }
+
+    setSeed((quint32) recording["seed"].toDouble());
+    replaying_ = true;
+
+    return true;
+}
+
+void RandomService::stopReplay()
+{
+    replaying_ = false;
+    replay_.clear();
+}
+
+bool RandomService::isReplaying() const
+{
+    return replaying_;
+}
+
+RandomService::RandomService()
+    : seed_(generateSeed())
+    , engines_()
+    , recording_(false)
+    , recorded_()
+    , replaying_(false)
+    , replay_()
+{}
+
+quint32 RandomService::hashStream(const QString &stream)
+{
+    // FNV-1a
+    quint32 hash = 2166136261u;
+    foreach(char c, stream.toUtf8()) {
+        hash ^= (quint8) c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+} // namespace Misc
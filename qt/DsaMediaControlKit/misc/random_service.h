@@ -0,0 +1,98 @@
+#ifndef MISC_RANDOM_SERVICE_H
+#define MISC_RANDOM_SERVICE_H
+
+#include <QString>
+#include <QHash>
+#include <QList>
+#include <QJsonObject>
+
+#include <random>
+
+namespace Misc {
+
+/*
+ * Shared source of randomness for all players.
+ * Each player draws from its own named stream. The engine of a stream
+ * is seeded from the session seed and the stream name, so the sequence
+ * of a player does not depend on draws of other players.
+ * Draws can be recorded, and a recorded session can be replayed,
+ * which returns the recorded values per stream in order.
+*/
+class RandomService
+{
+public:
+    /* Returns the instance shared by all players */
+    static RandomService* instance();
+
+    /*
+     * Sets session seed.
+     * All streams restart their sequence.
+    */
+    void setSeed(quint32 seed);
+    quint32 getSeed() const;
+
+    /* Returns a non-deterministic seed */
+    static quint32 generateSeed();
+
+    /*
+     * Returns engine of given stream.
+     * Draws made directly on the engine are neither recorded nor replayed,
+     * use takeReplayValue() and record() around them.
+    */
+    std::mt19937& getEngine(QString const& stream);
+
+    /*
+     * Returns uniformly distributed int in [min, max] from given stream.
+     * Value is recorded or replayed, if active.
+    */
+    int getInt(QString const& stream, int min, int max);
+
+    /*
+     * Takes next replayed value of stream into value.
+     * Returns false if not replaying or stream is exhausted.
+    */
+    bool takeReplayValue(QString const& stream, int* value);
+
+    /* Records value for stream if recording, returns value */
+    int record(QString const& stream, int value);
+
+    /*
+     * Starts recording all draws (clears previous recording).
+     * All streams restart their sequence.
+    */
+    void startRecording();
+    void stopRecording();
+    bool isRecording() const;
+
+    /* Returns recording as {"seed": n, "streams": {name: [values]}} */
+    const QJsonObject getRecording() const;
+
+    /*
+     * Replays given recording, see getRecording() for format.
+     * Seed is set to recorded seed, so streams continue deterministically
+     * once their recorded values are exhausted.
+     * Returns false if recording could not be parsed.
+    */
+    bool startReplay(QJsonObject const& recording);
+    void stopReplay();
+    bool isReplaying() const;
+
+private:
+    RandomService();
+
+    /* stable hash of stream name, independent of Qt hash seeding */
+    static quint32 hashStream(QString const& stream);
+
+    quint32 seed_;
+    QHash<QString, std::mt19937> engines_;
+
+    bool recording_;
+    QHash<QString, QList<int> > recorded_;
+
+    bool replaying_;
+    QHash<QString, QList<int> > replay_;
+};
+
+} // namespace Misc
+
+#endif // MISC_RANDOM_SERVICE_H
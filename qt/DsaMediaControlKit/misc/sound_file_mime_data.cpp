@@ -0,0 +1,98 @@
+#include "sound_file_mime_data.h"
+
+#include <QDataStream>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include "misc/json_mime_data_parser.h"
+
+namespace Misc {
+
+SoundFileMimeData::SoundFileMimeData()
+    : QMimeData()
+    , ids_()
+    , names_()
+    , paths_()
+    , text_()
+{}
+
+void SoundFileMimeData::append(int id, const QString &name, const QString &path)
+{
+    ids_.append(id);
+    names_.append(name);
+    paths_.append(path);
+}
+
+const QList<int> &SoundFileMimeData::getIds() const
+{
+    return ids_;
+}
+
+const QStringList &SoundFileMimeData::getNames() const
+{
+    return names_;
+}
+
+const QStringList &SoundFileMimeData::getPaths() const
+{
+    return paths_;
+}
+
+QList<int> SoundFileMimeData::toIds(const QMimeData *data)
+{
+    QList<int> ids;
+    if(data == 0)
+        return ids;
+
+    const SoundFileMimeData* sound_data = qobject_cast<const SoundFileMimeData*>(data);
+    if(sound_data)
+        return sound_data->getIds();
+
+    if(!data->hasFormat(SOUND_FILE_IDS_MIME_TYPE))
+        return ids;
+
+    QByteArray bytes = data->data(SOUND_FILE_IDS_MIME_TYPE);
+    QDataStream in(&bytes, QIODevice::ReadOnly);
+    in >> ids;
+    if(in.status() != QDataStream::Ok)
+        ids.clear();
+
+    return ids;
+}
+
+QStringList SoundFileMimeData::formats() const
+{
+    QStringList res;
+    res << SOUND_FILE_IDS_MIME_TYPE << "text/plain";
+    return res;
+}
+
+bool SoundFileMimeData::hasFormat(const QString &mime_type) const
+{
+    return mime_type == SOUND_FILE_IDS_MIME_TYPE || mime_type == "text/plain";
+}
+
+QVariant SoundFileMimeData::retrieveData(const QString &mime_type, QVariant::Type type) const
+{
+    if(mime_type == SOUND_FILE_IDS_MIME_TYPE) {
+        QByteArray bytes;
+        QDataStream out(&bytes, QIODevice::WriteOnly);
+        out << ids_;
+        return bytes;
+    }
+
+    if(mime_type == "text/plain") {
+        // same text as JsonMimeDataParser::toJsonMimeData(...)
+        if(text_.isEmpty()) {
+            QJsonArray arr;
+            for(int i = 0; i < ids_.size(); ++i)
+                arr.append(JsonMimeDataParser::toJsonObject(DB::SoundFileRecord(ids_[i], names_[i], paths_[i])));
+            text_ = QString(QJsonDocument(arr).toJson());
+        }
+        return text_;
+    }
+
+    return QMimeData::retrieveData(mime_type, type);
+}
+
+} // namespace Misc
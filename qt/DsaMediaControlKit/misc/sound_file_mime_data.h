@@ -0,0 +1,61 @@
+#ifndef MISC_SOUND_FILE_MIME_DATA_H
+#define MISC_SOUND_FILE_MIME_DATA_H
+
+#include <QMimeData>
+#include <QList>
+#include <QStringList>
+
+// mime type of dragged sound files, data is a list of record ids
+#define SOUND_FILE_IDS_MIME_TYPE "application/x-dsamediacontrolkit-sound-file-ids"
+
+namespace Misc {
+
+/*
+* Mime data of dragged sound files.
+* Carries record ids (plus name & path of each file), no serialized records.
+* Targets in this program read ids directly (see toIds(...)),
+* no data gets converted until a target asks for a format:
+* SOUND_FILE_IDS_MIME_TYPE is the encoded id list,
+* text/plain the JSON of JsonMimeDataParser (fallback for other targets).
+*/
+class SoundFileMimeData : public QMimeData
+{
+    Q_OBJECT
+public:
+    explicit SoundFileMimeData();
+
+    /* adds sound file to dragged files */
+    void append(int id, QString const& name, QString const& path);
+
+    QList<int> const& getIds() const;
+    QStringList const& getNames() const;
+    QStringList const& getPaths() const;
+
+    /*
+     * Returns ids of sound files in given mime data,
+     * without conversion if data is SoundFileMimeData.
+     * Returns empty list if data does not contain SOUND_FILE_IDS_MIME_TYPE.
+    */
+    static QList<int> toIds(const QMimeData* data);
+
+    /*
+     * QMimeData overrides
+    */
+    virtual QStringList formats() const;
+    virtual bool hasFormat(QString const& mime_type) const;
+
+protected:
+    virtual QVariant retrieveData(QString const& mime_type, QVariant::Type type) const;
+
+private:
+    QList<int> ids_;
+    QStringList names_;
+    QStringList paths_;
+
+    // JSON text, created on first request
+    mutable QString text_;
+};
+
+} // namespace Misc
+
+#endif // MISC_SOUND_FILE_MIME_DATA_H
@@ -1,8 +1,9 @@
 #include "playlist.h"
 
 #include <QDebug>
+#include <QSet>
 
-#include "misc/json_mime_data_parser.h"
+#include "misc/random_service.h"
 
 namespace Playlist {
 
@@ -12,18 +13,20 @@ Playlist::Playlist(QString name, QObject* parent)
     , settings_(0)
     , model_(0)
     , records_()
+    , url_entries_()
+    , scheduler_()
+    , random_stream_(name)
 {
     settings_ = new Settings;
+
+    connect(this, SIGNAL(mediaInserted(int,int)),
+            this, SLOT(onMediaInserted(int,int)));
+    connect(this, SIGNAL(mediaAboutToBeRemoved(int,int)),
+            this, SLOT(onMediaAboutToBeRemoved(int,int)));
 }
 
 Playlist::~Playlist()
 {
-    QList<QMediaContent*> keys = records_.keys();
-    while(keys.size() > 0) {
-        records_.remove(keys[0]);
-        delete keys[0];
-        keys.pop_front();
-    }
     delete settings_;
 }
 
@@ -34,6 +37,14 @@ bool Playlist::setSettings(Settings *settings)
     }
 
     settings_->copyFrom(*settings);
+
+    if(settings_->weighted_mode == WEIGHTED_NO_REPEAT)
+        scheduler_.setMode(WeightedScheduler::NO_REPEAT, settings_->no_repeat_count);
+    else if(settings_->weighted_mode == WEIGHTED_SHUFFLE_BAG)
+        scheduler_.setMode(WeightedScheduler::SHUFFLE_BAG);
+    else
+        scheduler_.setMode(WeightedScheduler::INDEPENDENT);
+
     emit changedSettings();
     return true;
 }
@@ -45,10 +56,15 @@ Settings *Playlist::getSettings()
 
 void Playlist::setSoundFileModel(DB::Model::SoundFileTableModel *m)
 {
+    if(model_ != 0)
+        disconnect(model_, 0, this, 0);
+
     model_ = m;
 
-    connect(this, SIGNAL(mediaAboutToBeRemoved(int,int)),
-            this, SLOT(onMediaAboutToBeRemoved(int,int)));
+    if(model_ != 0) {
+        connect(model_, SIGNAL(weightChanged(DB::SoundFileRecord*)),
+                this, SLOT(onSoundFileWeightChanged(DB::SoundFileRecord*)));
+    }
 }
 
 const DB::Model::SoundFileTableModel *Playlist::getSoundFileModel() const
@@ -69,32 +85,50 @@ bool Playlist::addMedia(int record_id)
     if(rec == 0)
         return false;
 
-    QMediaContent* c = new QMediaContent(QUrl("file:///" + rec->path));
+    QUrl url("file:///" + rec->path);
 
     // this should very rarely occur
-    QList<QMediaContent*> delete_recs;
-    foreach(QMediaContent* r_c, records_.keys()) {
-        if(*r_c == *c) {
-            QString old_str = Misc::JsonMimeDataParser::toJsonMimeData(records_[r_c])->text();
-            QString new_str = Misc::JsonMimeDataParser::toJsonMimeData(rec)->text();
-            qDebug() << "Sound file was already set for media content.";
-            qDebug() << " > Record will be replaced.";
-            qDebug() << " > old:" << old_str;
-            qDebug() << " > new:" << new_str;
-            delete_recs.append(r_c);
-        }
+    UrlEntry& entry = url_entries_[url];
+    if(entry.record != 0 && entry.record != rec) {
+        qDebug() << "Sound file was already set for media content.";
+        qDebug() << " > Record will be replaced for media added from now on.";
+        qDebug() << " > old id:" << entry.record->id << "new id:" << rec->id;
     }
-    while(delete_recs.size() > 0) {
-        records_.remove(delete_recs[0]);
-        delete delete_recs[0];
-        delete_recs.pop_front();
-    }
-    //
+    entry.record = rec;
 
-    if(!QMediaPlaylist::addMedia(*c))
+    // records_ gets updated by onMediaInserted
+    if(!QMediaPlaylist::addMedia(QMediaContent(url))) {
+        if(url_entries_[url].count == 0)
+            url_entries_.remove(url);
         return false;
+    }
+
+    return true;
+}
+
+bool Playlist::addMedia(const QList<DB::SoundFileRecord *> &records)
+{
+    if(records.isEmpty())
+        return true;
+
+    QList<QMediaContent> contents;
+    foreach(DB::SoundFileRecord* rec, records) {
+        if(rec == 0)
+            return false;
+
+        QUrl url("file:///" + rec->path);
+        url_entries_[url].record = rec;
+        contents.append(QMediaContent(url));
+    }
 
-    records_[c] = rec;
+    // records_ gets updated by onMediaInserted
+    if(!QMediaPlaylist::addMedia(contents)) {
+        foreach(QMediaContent const& c, contents) {
+            if(url_entries_.value(c.canonicalUrl()).count == 0)
+                url_entries_.remove(c.canonicalUrl());
+        }
+        return false;
+    }
 
     return true;
 }
@@ -102,45 +136,88 @@ bool Playlist::addMedia(int record_id)
 const QList<DB::SoundFileRecord *> Playlist::getSoundFileList(bool unique)
 {
     QList<DB::SoundFileRecord*> sf_list;
-
-    if(unique) {
-        foreach(DB::SoundFileRecord* rec, records_.values()) {
-            if(sf_list.contains(rec))
+    sf_list.reserve(records_.size());
+
+    QSet<DB::SoundFileRecord*> contained;
+    foreach(DB::SoundFileRecord* rec, records_) {
+        if(rec == 0)
+            continue;
+        if(unique) {
+            if(contained.contains(rec))
                 continue;
-            sf_list.append(rec);
-        }
-    }
-    else {
-        for(int i = 0; i < mediaCount(); ++i) {
-            QMediaContent c = media(i);
-            foreach(QMediaContent* r_c, records_.keys()) {
-                if(*r_c == c) {
-                    sf_list.append(records_[r_c]);
-                    break;
-                }
-            }
+            contained.insert(rec);
         }
+        sf_list.append(rec);
     }
 
     return sf_list;
 }
 
+DB::SoundFileRecord *Playlist::getSoundFileRecord(int index) const
+{
+    if(index < 0 || index >= records_.size())
+        return 0;
+    return records_[index];
+}
+
+QString Playlist::getLocalFile(int index) const
+{
+    return media(index).canonicalUrl().toLocalFile();
+}
+
+int Playlist::nextWeightedIndex()
+{
+    Misc::RandomService* random = Misc::RandomService::instance();
+    QString stream = random_stream_ + "/weighted";
+
+    int index = -1;
+    if(random->takeReplayValue(stream, &index) && index >= 0 && index < mediaCount())
+        return random->record(stream, index);
+
+    return random->record(stream, scheduler_.next(random->getEngine(stream)));
+}
+
+void Playlist::setRandomStream(const QString &stream)
+{
+    random_stream_ = stream;
+}
+
+const QString &Playlist::getRandomStream() const
+{
+    return random_stream_;
+}
+
+void Playlist::onMediaInserted(int start, int end)
+{
+    records_.insert(start, end - start + 1, 0);
+    scheduler_.insert(start, end - start + 1);
+    for(int i = start; i <= end; ++i) {
+        UrlEntry& entry = url_entries_[media(i).canonicalUrl()];
+        ++entry.count;
+        records_[i] = entry.record;
+        if(entry.record != 0)
+            scheduler_.setWeight(i, entry.record->weight);
+    }
+}
+
 void Playlist::onMediaAboutToBeRemoved(int start, int end)
 {
     for(int i = start; i <= end; ++i) {
-        QMediaContent c = media(i);
-        QMediaContent* remove_key = 0;
-        foreach(QMediaContent* r_c, records_.keys()) {
-            if(*r_c == c) {
-                remove_key = r_c;
-            }
-        }
-        if(remove_key != 0) {
-            records_.remove(remove_key);
-            delete remove_key;
-        }
+        QUrl url = media(i).canonicalUrl();
+        QHash<QUrl, UrlEntry>::iterator it = url_entries_.find(url);
+        if(it != url_entries_.end() && --it.value().count <= 0)
+            url_entries_.erase(it);
     }
+    records_.remove(start, end - start + 1);
+    scheduler_.remove(start, end - start + 1);
 }
 
-} // namespace Playlist
+void Playlist::onSoundFileWeightChanged(DB::SoundFileRecord *rec)
+{
+    for(int i = 0; i < records_.size(); ++i) {
+        if(records_[i] == rec)
+            scheduler_.setWeight(i, rec->weight);
+    }
+}
 
+} // namespace Playlist
@@ -2,14 +2,22 @@
 #define PLAYLIST_PLAYLIST_H
 
 #include <QMediaPlaylist>
-#include <QMap>
-#include <QSet>
+#include <QVector>
+#include <QHash>
+#include <QUrl>
 
 #include "settings.h"
+#include "weighted_scheduler.h"
 #include "db/model/sound_file_table_model.h"
 
 namespace Playlist {
 
+/*
+ * QMediaPlaylist which keeps track of the SoundFileRecord
+ * each media is based on.
+ * Records are stored in a vector parallel to the media indices,
+ * media inserted without a record are resolved by url.
+*/
 class Playlist : public QMediaPlaylist
 {
     Q_OBJECT
@@ -29,19 +37,72 @@ public:
     bool addMedia(const DB::SoundFileRecord& rec);
     bool addMedia(int record_id);
 
+    /*
+     * Adds records (of the sound file model) at once,
+     * so listeners get notified of a single insertion.
+    */
+    bool addMedia(QList<DB::SoundFileRecord*> const& records);
+
+    /*
+     * Gets the SoundFileRecords of all media, in playlist order.
+     * If unique is set, each record is contained only once.
+    */
     const QList<DB::SoundFileRecord*> getSoundFileList(bool unique = false);
 
+    /*
+     * Gets the SoundFileRecord of media at given index.
+     * Returns 0 if none found.
+    */
+    DB::SoundFileRecord* getSoundFileRecord(int index) const;
+
+    /* Returns local file path of media at given index */
+    QString getLocalFile(int index) const;
+
+    /*
+     * Draws next media index based on weights of the SoundFileRecords
+     * and weighted mode of the settings.
+     * Returns -1 if no media has a positive weight.
+    */
+    int nextWeightedIndex();
+
+    /*
+     * Name of the random stream used by this playlist and its player
+     * (see Misc::RandomService). Has to be stable across sessions.
+    */
+    void setRandomStream(QString const& stream);
+    QString const& getRandomStream() const;
+
 signals:
     void changedSettings();
 
 private slots:
+    void onMediaInserted(int start, int end);
     void onMediaAboutToBeRemoved(int start, int end);
+    void onSoundFileWeightChanged(DB::SoundFileRecord* rec);
 
 private:
+    /* Record associated with a media url and number of media using it */
+    struct UrlEntry {
+        DB::SoundFileRecord* record;
+        int count;
+
+        UrlEntry(DB::SoundFileRecord* rec = 0)
+            : record(rec)
+            , count(0)
+        {}
+    };
+
     QString name_;
     Settings* settings_;
     DB::Model::SoundFileTableModel* model_;
-    QMap<QMediaContent*, DB::SoundFileRecord*> records_;
+
+    // record of each media index
+    QVector<DB::SoundFileRecord*> records_;
+    QHash<QUrl, UrlEntry> url_entries_;
+
+    // weights of each media index
+    WeightedScheduler scheduler_;
+    QString random_stream_;
 
 };
 
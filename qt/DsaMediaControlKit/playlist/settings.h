@@ -3,6 +3,10 @@
 
 #include <QString>
 
+// range of crossfade_duration in milliseconds
+#define CROSSFADE_MIN_DURATION 100
+#define CROSSFADE_MAX_DURATION 10000
+
 namespace Playlist{
 
 /*
@@ -17,6 +21,18 @@ enum PlayOrder{
     WEIGTHED
 };
 
+/*
+ * Describes how weighted order draws its sound files.
+ * independent: every draw follows the weights.
+ * no repeat: a sound file is not drawn again within the last no_repeat_count draws.
+ * shuffle bag: all sound files are drawn (weighted number of times) before any repeats.
+*/
+enum WeightedMode{
+    WEIGHTED_INDEPENDENT,
+    WEIGHTED_NO_REPEAT,
+    WEIGHTED_SHUFFLE_BAG
+};
+
 /*
  * Struct describing how a playlist should play its sound files.
 */
@@ -29,7 +45,10 @@ struct Settings{
     int min_delay_interval;
     int max_delay_interval;
     int volume;
-
+    WeightedMode weighted_mode;
+    int no_repeat_count;
+    bool crossfade_flag;
+    int crossfade_duration; // in milliseconds
 
     Settings()
         : name("Settings")
@@ -39,6 +58,10 @@ struct Settings{
         , min_delay_interval(0)
         , max_delay_interval(0)
         , volume(100)
+        , weighted_mode(WEIGHTED_INDEPENDENT)
+        , no_repeat_count(0)
+        , crossfade_flag(false)
+        , crossfade_duration(2000)
     {}
 
     Settings(QString n,PlayOrder ord, bool loop, bool interval, int min_interval, int max_interval, int vol)
@@ -49,6 +72,10 @@ struct Settings{
         , min_delay_interval(min_interval)
         , max_delay_interval(max_interval)
         , volume(vol)
+        , weighted_mode(WEIGHTED_INDEPENDENT)
+        , no_repeat_count(0)
+        , crossfade_flag(false)
+        , crossfade_duration(2000)
     {}
 
     Settings(Settings *settings)
@@ -59,6 +86,10 @@ struct Settings{
         , min_delay_interval(settings->min_delay_interval)
         , max_delay_interval(settings->max_delay_interval)
         , volume(settings->volume)
+        , weighted_mode(settings->weighted_mode)
+        , no_repeat_count(settings->no_repeat_count)
+        , crossfade_flag(settings->crossfade_flag)
+        , crossfade_duration(settings->crossfade_duration)
     {}
 
     void copyFrom(const Settings& settings)
@@ -70,6 +101,10 @@ struct Settings{
         min_delay_interval = settings.min_delay_interval;
         max_delay_interval = settings.max_delay_interval;
         volume = settings.volume;
+        weighted_mode = settings.weighted_mode;
+        no_repeat_count = settings.no_repeat_count;
+        crossfade_flag = settings.crossfade_flag;
+        crossfade_duration = settings.crossfade_duration;
 
     }
 };
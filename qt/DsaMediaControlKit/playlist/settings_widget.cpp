@@ -16,11 +16,15 @@ SettingsWidget::SettingsWidget(Playlist* playlist,QWidget *parent)
     , min_interval_slider_(0)
     , max_interval_slider_(0)
     , interval_label_(0)
+    , crossfade_checkbox_(0)
+    , crossfade_spin_box_(0)
     , volume_slider_(0)
     , volume_label_(0)
     , normal_radio_button_(0)
     , shuffle_radio_button_(0)
     , weighted_radio_button_(0)
+    , weighted_mode_combo_box_(0)
+    , no_repeat_spin_box_(0)
     , save_button_(0)
     , close_button_(0)
 {
@@ -69,6 +73,10 @@ void SettingsWidget::onSaveClicked(bool)
         new_settings->max_delay_interval = 0;
     }
 
+    //set crossfade settings
+    new_settings->crossfade_flag = crossfade_checkbox_->isChecked();
+    new_settings->crossfade_duration = crossfade_spin_box_->value();
+
     //set playorder settings
     if (normal_radio_button_->isChecked())
     {
@@ -80,6 +88,8 @@ void SettingsWidget::onSaveClicked(bool)
     {
         new_settings->order = PlayOrder::WEIGTHED;
     }
+    new_settings->weighted_mode = (WeightedMode) weighted_mode_combo_box_->currentIndex();
+    new_settings->no_repeat_count = no_repeat_spin_box_->value();
 
     //set volume
     new_settings->volume = volume_slider_->value();
@@ -140,6 +150,16 @@ void SettingsWidget::initWidgets()
     max_interval_slider_->setMaximum(60);
     max_interval_slider_->setValue(playlist_->getSettings()->max_delay_interval);
 
+    crossfade_checkbox_ = new QCheckBox(tr("Crossfade"),this);
+    crossfade_checkbox_->setChecked(playlist_->getSettings()->crossfade_flag);
+
+    crossfade_spin_box_ = new QSpinBox(this);
+    crossfade_spin_box_->setSuffix(tr(" ms"));
+    crossfade_spin_box_->setMinimum(CROSSFADE_MIN_DURATION);
+    crossfade_spin_box_->setMaximum(CROSSFADE_MAX_DURATION);
+    crossfade_spin_box_->setSingleStep(100);
+    crossfade_spin_box_->setValue(playlist_->getSettings()->crossfade_duration);
+
     volume_slider_ = new QSlider(Qt::Horizontal,this);
     volume_label_ = new QLabel(this);
     volume_slider_->setMinimum(0);
@@ -163,6 +183,18 @@ void SettingsWidget::initWidgets()
         weighted_radio_button_->setChecked(true);
     }
 
+    weighted_mode_combo_box_ = new QComboBox(this);
+    weighted_mode_combo_box_->addItem(tr("Independent"));
+    weighted_mode_combo_box_->addItem(tr("No Repeat"));
+    weighted_mode_combo_box_->addItem(tr("Shuffle Bag"));
+    weighted_mode_combo_box_->setCurrentIndex(playlist_->getSettings()->weighted_mode);
+
+    no_repeat_spin_box_ = new QSpinBox(this);
+    no_repeat_spin_box_->setPrefix(tr("No repeat within "));
+    no_repeat_spin_box_->setMinimum(0);
+    no_repeat_spin_box_->setMaximum(100);
+    no_repeat_spin_box_->setValue(playlist_->getSettings()->no_repeat_count);
+
     save_button_ = new QPushButton("Save", this);
     close_button_ = new QPushButton("Cancel", this);
 
@@ -189,6 +221,8 @@ void SettingsWidget::initLayout()
     playmode_layout->addWidget(normal_radio_button_);
     playmode_layout->addWidget(shuffle_radio_button_);
     playmode_layout->addWidget(weighted_radio_button_);
+    playmode_layout->addWidget(weighted_mode_combo_box_);
+    playmode_layout->addWidget(no_repeat_spin_box_);
     playmode_layout->addStretch(1);
     playmode_box->setLayout(playmode_layout);
 
@@ -199,6 +233,8 @@ void SettingsWidget::initLayout()
     interval_layout->addWidget(min_interval_slider_);
     interval_layout->addWidget(max_interval_slider_);
     interval_layout->addWidget(interval_label_);
+    interval_layout->addWidget(crossfade_checkbox_);
+    interval_layout->addWidget(crossfade_spin_box_);
     interval_box->setLayout(interval_layout);
 
     QGroupBox *volume_box = new QGroupBox(tr("Volume Options"),this);
@@ -227,7 +263,7 @@ void SettingsWidget::initLayout()
     layout->addWidget(bottom_box);
     setLayout(layout);
 
-    setFixedHeight(300);
+    setFixedHeight(400);
     setFixedWidth(600);
 }
 
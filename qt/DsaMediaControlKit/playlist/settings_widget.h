@@ -8,6 +8,8 @@
 #include <QLineEdit>
 #include <QPushButton>
 #include <QRadioButton>
+#include <QComboBox>
+#include <QSpinBox>
 
 #include "playlist.h"
 
@@ -48,11 +50,15 @@ private:
     QSlider* min_interval_slider_;
     QSlider* max_interval_slider_;
     QLabel* interval_label_;
+    QCheckBox* crossfade_checkbox_;
+    QSpinBox* crossfade_spin_box_;
     QSlider* volume_slider_;
     QLabel* volume_label_;
     QRadioButton* normal_radio_button_;
     QRadioButton* shuffle_radio_button_;
     QRadioButton* weighted_radio_button_;
+    QComboBox* weighted_mode_combo_box_;
+    QSpinBox* no_repeat_spin_box_;
     QPushButton* save_button_;
     QPushButton* close_button_;
 };
@@ -0,0 +1,326 @@
+#include "weighted_scheduler.h"
+
+#include <algorithm>
+#include <cmath>
+
+// number of alias draws rejected in NO_REPEAT mode before falling back to a scan
+#define NO_REPEAT_MAX_REJECTS 16
+// weights are scaled to integers of this resolution for the shuffle bag,
+// divisible by 1..16, so ratios with small denominators stay exact
+#define SHUFFLE_BAG_RESOLUTION 720720
+// copies in a shuffle bag, if integer weight ratios need more
+#define SHUFFLE_BAG_MAX_SIZE 1024
+
+namespace Playlist {
+
+/*
+ * Returns greatest common divisor of a and b (gcd(0, b) = b).
+ **/
+static long long gcd(long long a, long long b)
+{
+    while(b != 0) {
+        long long r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+WeightedScheduler::WeightedScheduler()
+    : weights_()
+    , prob_()
+    , alias_()
+    , total_(0)
+    , positive_(0)
+    , dirty_(false)
+    , mode_(INDEPENDENT)
+    , no_repeat_count_(0)
+    , recent_()
+    , recent_count_()
+    , bag_()
+    , bag_credit_()
+{}
+
+void WeightedScheduler::setMode(WeightedScheduler::Mode mode, int no_repeat_count)
+{
+    if(mode == mode_ && no_repeat_count == no_repeat_count_)
+        return;
+
+    mode_ = mode;
+    no_repeat_count_ = std::max(no_repeat_count, 0);
+    resetHistory();
+}
+
+WeightedScheduler::Mode WeightedScheduler::getMode() const
+{
+    return mode_;
+}
+
+int WeightedScheduler::size() const
+{
+    return (int) weights_.size();
+}
+
+void WeightedScheduler::insert(int index, int count, double weight)
+{
+    if(index < 0 || index > size() || count <= 0)
+        return;
+
+    weights_.insert(weights_.begin() + index, count, std::max(weight, 0.0));
+    dirty_ = true;
+    resetHistory();
+}
+
+void WeightedScheduler::remove(int index, int count)
+{
+    if(index < 0 || count <= 0 || index + count > size())
+        return;
+
+    weights_.erase(weights_.begin() + index, weights_.begin() + index + count);
+    dirty_ = true;
+    resetHistory();
+}
+
+void WeightedScheduler::clear()
+{
+    weights_.clear();
+    dirty_ = true;
+    resetHistory();
+}
+
+void WeightedScheduler::setWeight(int index, double weight)
+{
+    if(index < 0 || index >= size())
+        return;
+
+    weight = std::max(weight, 0.0);
+    if(weights_[index] == weight)
+        return;
+
+    weights_[index] = weight;
+    dirty_ = true;
+
+    // bag contents no longer match weights
+    bag_.clear();
+    bag_credit_.clear();
+}
+
+double WeightedScheduler::getWeight(int index) const
+{
+    if(index < 0 || index >= size())
+        return 0;
+    return weights_[index];
+}
+
+double WeightedScheduler::getProbability(int index) const
+{
+    if(index < 0 || index >= size())
+        return 0;
+
+    double total = 0;
+    for(size_t i = 0; i < weights_.size(); ++i)
+        total += weights_[i];
+
+    if(total <= 0)
+        return 0;
+    return weights_[index] / total;
+}
+
+int WeightedScheduler::next(std::mt19937 &rng)
+{
+    if(dirty_)
+        rebuild();
+
+    if(positive_ == 0)
+        return -1;
+
+    int index = -1;
+
+    if(mode_ == SHUFFLE_BAG) {
+        // rounding of carried fractions may leave a refill without copies
+        while(bag_.empty())
+            refillBag(rng);
+        index = bag_.back();
+        bag_.pop_back();
+        return index;
+    }
+
+    if(mode_ == NO_REPEAT && getExcludeCount() > 0) {
+        for(int i = 0; i < NO_REPEAT_MAX_REJECTS && index == -1; ++i) {
+            int candidate = sampleAlias(rng);
+            if(recent_count_[candidate] == 0)
+                index = candidate;
+        }
+
+        // recently drawn indices hold most of the weight
+        if(index == -1)
+            index = sampleExcludingRecent(rng);
+
+        remember(index);
+        return index;
+    }
+
+    return sampleAlias(rng);
+}
+
+void WeightedScheduler::rebuild()
+{
+    int n = size();
+    dirty_ = false;
+
+    prob_.assign(n, 0.0);
+    alias_.assign(n, 0);
+    recent_count_.resize(n, 0);
+
+    total_ = 0;
+    positive_ = 0;
+    for(int i = 0; i < n; ++i) {
+        total_ += weights_[i];
+        if(weights_[i] > 0)
+            ++positive_;
+    }
+
+    if(positive_ == 0)
+        return;
+
+    // scale weights, so average equals 1
+    std::vector<double> scaled(n);
+    std::vector<int> small;
+    std::vector<int> large;
+    for(int i = 0; i < n; ++i) {
+        scaled[i] = weights_[i] * n / total_;
+        if(scaled[i] < 1.0)
+            small.push_back(i);
+        else
+            large.push_back(i);
+    }
+
+    while(!small.empty() && !large.empty()) {
+        int s = small.back();
+        small.pop_back();
+        int l = large.back();
+
+        prob_[s] = scaled[s];
+        alias_[s] = l;
+
+        scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+        if(scaled[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+
+    // remaining entries are 1 up to rounding errors
+    while(!large.empty()) {
+        prob_[large.back()] = 1.0;
+        large.pop_back();
+    }
+    while(!small.empty()) {
+        prob_[small.back()] = 1.0;
+        small.pop_back();
+    }
+}
+
+int WeightedScheduler::sampleAlias(std::mt19937 &rng)
+{
+    std::uniform_int_distribution<int> column(0, size() - 1);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+
+    int i = column(rng);
+    if(coin(rng) < prob_[i])
+        return i;
+    return alias_[i];
+}
+
+int WeightedScheduler::sampleExcludingRecent(std::mt19937 &rng)
+{
+    double total = 0;
+    for(int i = 0; i < size(); ++i) {
+        if(recent_count_[i] == 0)
+            total += weights_[i];
+    }
+
+    std::uniform_real_distribution<double> dist(0.0, total);
+    double r = dist(rng);
+
+    int last = -1;
+    for(int i = 0; i < size(); ++i) {
+        if(recent_count_[i] != 0 || weights_[i] <= 0)
+            continue;
+        last = i;
+        r -= weights_[i];
+        if(r < 0)
+            return i;
+    }
+
+    return last;
+}
+
+void WeightedScheduler::refillBag(std::mt19937 &rng)
+{
+    double max_weight = 0;
+    for(int i = 0; i < size(); ++i)
+        max_weight = std::max(max_weight, weights_[i]);
+
+    // integer weights, reduced by their greatest common divisor
+    std::vector<long long> units(size(), 0);
+    long long divisor = 0;
+    for(int i = 0; i < size(); ++i) {
+        if(weights_[i] <= 0)
+            continue;
+        units[i] = std::max(std::llround(weights_[i] / max_weight * SHUFFLE_BAG_RESOLUTION), 1LL);
+        divisor = gcd(divisor, units[i]);
+    }
+
+    long long total = 0;
+    for(int i = 0; i < size(); ++i) {
+        units[i] /= divisor;
+        total += units[i];
+    }
+
+    // at least one copy per positive index on average keeps the bag filled
+    double copies_per_unit = 1.0;
+    if(total > SHUFFLE_BAG_MAX_SIZE)
+        copies_per_unit = (double) std::max(SHUFFLE_BAG_MAX_SIZE, positive_) / total;
+
+    // fractions of copies are carried over to the next bag
+    bag_credit_.resize(size(), 0.0);
+    bag_.clear();
+    for(int i = 0; i < size(); ++i) {
+        if(units[i] == 0)
+            continue;
+        bag_credit_[i] += units[i] * copies_per_unit;
+        int copies = (int) std::floor(bag_credit_[i]);
+        bag_credit_[i] -= copies;
+        bag_.insert(bag_.end(), copies, i);
+    }
+
+    std::shuffle(bag_.begin(), bag_.end(), rng);
+}
+
+void WeightedScheduler::remember(int index)
+{
+    recent_.push_back(index);
+    ++recent_count_[index];
+
+    while((int) recent_.size() > getExcludeCount()) {
+        --recent_count_[recent_.front()];
+        recent_.pop_front();
+    }
+}
+
+void WeightedScheduler::resetHistory()
+{
+    recent_.clear();
+    recent_count_.assign(weights_.size(), 0);
+    bag_.clear();
+    bag_credit_.clear();
+}
+
+int WeightedScheduler::getExcludeCount() const
+{
+    // at least one index has to stay available
+    return std::min(no_repeat_count_, positive_ - 1);
+}
+
+} // namespace Playlist
@@ -0,0 +1,108 @@
+#ifndef PLAYLIST_WEIGHTED_SCHEDULER_H
+#define PLAYLIST_WEIGHTED_SCHEDULER_H
+
+#include <vector>
+#include <deque>
+#include <random>
+
+namespace Playlist {
+
+/*
+ * Draws playlist indices with probability proportional to their weight.
+ * Sampling is O(1) using an alias table (Vose's method).
+ * Weight changes only mark the table dirty, it gets rebuilt once (O(n))
+ * on the next draw, so any number of changes costs a single rebuild.
+ * Indices mirror the media indices of the playlist (see insert/remove).
+*/
+class WeightedScheduler
+{
+public:
+    /*
+     * INDEPENDENT: every draw follows the weights.
+     * NO_REPEAT: an index is not drawn again within the last N draws.
+     * SHUFFLE_BAG: each index is put into a bag with a number of copies
+     * proportional to its weight, bag is drawn empty before refilling.
+     * Copies follow the integer ratios of the weights (exact for ratios
+     * with denominators up to 16, e.g. 1 : 2.5 : 0.25). If these ratios
+     * need more than 1024 copies, the bag holds about 1024 copies and
+     * fractions of copies are carried over to the next bag, so counts of
+     * any index stay within one copy of its share over all bags.
+    */
+    enum Mode {
+        INDEPENDENT,
+        NO_REPEAT,
+        SHUFFLE_BAG
+    };
+
+    WeightedScheduler();
+
+    /* no_repeat_count is only used in NO_REPEAT mode */
+    void setMode(Mode mode, int no_repeat_count = 0);
+    Mode getMode() const;
+
+    int size() const;
+
+    /* Inserts count indices with given weight before index */
+    void insert(int index, int count, double weight = 1.0);
+
+    /* Removes count indices starting at index */
+    void remove(int index, int count);
+
+    void clear();
+
+    /* Sets weight of index, negative weights are treated as 0 */
+    void setWeight(int index, double weight);
+    double getWeight(int index) const;
+
+    /*
+     * Returns probability of index in INDEPENDENT mode.
+     * Returns 0 if index invalid or all weights are 0.
+    */
+    double getProbability(int index) const;
+
+    /*
+     * Draws next index using given engine.
+     * Returns -1 if there is no index with positive weight.
+    */
+    int next(std::mt19937& rng);
+
+private:
+    /* rebuilds alias table from weights */
+    void rebuild();
+
+    /* draws from alias table */
+    int sampleAlias(std::mt19937& rng);
+
+    /* draws by linear scan, skipping recently drawn indices */
+    int sampleExcludingRecent(std::mt19937& rng);
+
+    /* fills and shuffles bag based on weights */
+    void refillBag(std::mt19937& rng);
+
+    /* adds index to history of recent draws */
+    void remember(int index);
+
+    /* clears draw history and bag, after indices changed */
+    void resetHistory();
+
+    /* number of recent draws to exclude in NO_REPEAT mode */
+    int getExcludeCount() const;
+
+    std::vector<double> weights_;
+    std::vector<double> prob_;
+    std::vector<int> alias_;
+    double total_;
+    int positive_;
+    bool dirty_;
+
+    Mode mode_;
+    int no_repeat_count_;
+    std::deque<int> recent_;
+    std::vector<int> recent_count_;
+    std::vector<int> bag_;
+    std::vector<double> bag_credit_;
+};
+
+} // namespace Playlist
+
+#endif // PLAYLIST_WEIGHTED_SCHEDULER_H
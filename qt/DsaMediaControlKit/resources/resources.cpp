@@ -324,6 +324,11 @@ QPixmap *Resources::getKeyPixmap(const QChar &k)
 */
 QString Resources::DATABASE_PATH = "../../db/dsamediacontrolkit.db";
 
+/*
+* AUTOSAVE
+*/
+QString Resources::AUTOSAVE_DIR = "../../db/autosave";
+
 /*
 * ICONS
 */
@@ -18,6 +18,11 @@ struct Resources
     */
     static QString DATABASE_PATH;
 
+    /*
+    * autosave directory (journal & snapshot of the board)
+    */
+    static QString AUTOSAVE_DIR;
+
     /*
     * ICONS
     */
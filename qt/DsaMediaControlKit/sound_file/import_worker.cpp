@@ -0,0 +1,97 @@
+#include "import_worker.h"
+
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+
+namespace SoundFile {
+
+ScanWorker::ScanWorker(const QString &base_dir, QSharedPointer<ImportContext> context, QObject *parent)
+    : QObject(parent)
+    , base_dir_(base_dir)
+    , context_(context)
+{}
+
+const QStringList ScanWorker::nameFilters()
+{
+    return QStringList() << "*.mp3" << "*.wma" << "*.wav";
+}
+
+void ScanWorker::run()
+{
+    int scanned = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QDirIterator it(base_dir_, nameFilters(), QDir::Files, QDirIterator::Subdirectories);
+    while(it.hasNext() && !context_->isCancelled()) {
+        if(!context_->paths.push(it.next()))
+            break;
+
+        ++scanned;
+        if(timer.elapsed() > 100) {
+            emit progressChanged(scanned);
+            timer.start();
+        }
+    }
+
+    // no more paths will follow
+    context_->paths.close();
+
+    emit progressChanged(scanned);
+    emit finished(scanned);
+}
+
+CategoryWorker::CategoryWorker(const DB::ResourceDirRecord &resource_dir, QSharedPointer<ImportContext> context,
+                               int batch_size, QObject *parent)
+    : QObject(parent)
+    , resource_dir_(resource_dir)
+    , context_(context)
+    , batch_size_(batch_size)
+{}
+
+void CategoryWorker::run()
+{
+    int categorized = 0;
+    QList<DB::SoundFile> batch;
+    QString path;
+
+    while(context_->paths.pop(path)) {
+        batch.append(DB::SoundFile(QFileInfo(path), resource_dir_));
+        ++categorized;
+
+        if(batch.size() >= batch_size_) {
+            if(!emitBatch(batch))
+                break;
+            emit progressChanged(categorized);
+        }
+    }
+
+    if(batch.size() > 0 && !context_->isCancelled())
+        emitBatch(batch);
+
+    emit progressChanged(categorized);
+    emit finished();
+}
+
+bool CategoryWorker::emitBatch(QList<DB::SoundFile>& batch)
+{
+    // wait until GUI thread has written enough of the previous batches
+    while(!context_->batch_slots.tryAcquire(1, 50)) {
+        if(context_->isCancelled())
+            return false;
+    }
+
+    if(context_->isCancelled()) {
+        context_->batch_slots.release();
+        return false;
+    }
+
+    emit batchReady(batch);
+    batch.clear();
+
+    return true;
+}
+
+} // namespace SoundFile
@@ -0,0 +1,105 @@
+#ifndef SOUND_FILE_IMPORT_WORKER_H
+#define SOUND_FILE_IMPORT_WORKER_H
+
+#include <QObject>
+#include <QStringList>
+#include <QSemaphore>
+#include <QAtomicInt>
+#include <QSharedPointer>
+
+#include "db/sound_file.h"
+#include "misc/bounded_queue.h"
+
+namespace SoundFile {
+
+/*
+ * State shared between the stages of one folder import.
+ * paths: file paths found by ScanWorker, consumed by CategoryWorker.
+ * batch_slots: limits the number of batches handed to the
+ * GUI thread which have not been written to the DB yet.
+*/
+struct ImportContext {
+    Misc::BoundedQueue<QString> paths;
+    QSemaphore batch_slots;
+    QAtomicInt cancelled;
+
+    ImportContext(int queue_size, int batches_in_flight)
+        : paths(queue_size)
+        , batch_slots(batches_in_flight)
+        , cancelled(0)
+    {}
+
+    void cancel()
+    {
+        cancelled.store(1);
+        paths.cancel();
+    }
+
+    bool isCancelled() const
+    {
+        return cancelled.load() != 0;
+    }
+};
+
+/*
+ * First stage of the import pipeline.
+ * Walks given directory tree and pushes the path
+ * of every sound file into the shared path queue.
+*/
+class ScanWorker : public QObject
+{
+    Q_OBJECT
+public:
+    ScanWorker(QString const& base_dir, QSharedPointer<ImportContext> context, QObject* parent = 0);
+
+    /* name filters for files recognized as sound files */
+    static QStringList const nameFilters();
+
+signals:
+    void progressChanged(int scanned);
+    void finished(int scanned);
+
+public slots:
+    void run();
+
+private:
+    QString base_dir_;
+    QSharedPointer<ImportContext> context_;
+};
+
+/*
+ * Second stage of the import pipeline.
+ * Takes paths from the shared path queue, creates DB::SoundFile
+ * instances (which computes their category path) and hands them
+ * out in batches of fixed size.
+*/
+class CategoryWorker : public QObject
+{
+    Q_OBJECT
+public:
+    CategoryWorker(DB::ResourceDirRecord const& resource_dir, QSharedPointer<ImportContext> context,
+                   int batch_size, QObject* parent = 0);
+
+signals:
+    void batchReady(QList<DB::SoundFile> const&);
+    void progressChanged(int categorized);
+    void finished();
+
+public slots:
+    void run();
+
+private:
+    /*
+     * Waits for a free batch slot and emits batchReady.
+     * Returns false if import got cancelled meanwhile.
+    */
+    bool emitBatch(QList<DB::SoundFile>& batch);
+
+    DB::ResourceDirRecord resource_dir_;
+    QSharedPointer<ImportContext> context_;
+    int batch_size_;
+};
+
+} // namespace SoundFile
+
+#endif // SOUND_FILE_IMPORT_WORKER_H
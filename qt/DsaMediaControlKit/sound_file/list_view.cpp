@@ -7,9 +7,11 @@
 #include <QPixmap>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QElapsedTimer>
 
 #include "resources/resources.h"
 #include "misc/json_mime_data_parser.h"
+#include "misc/sound_file_mime_data.h"
 
 namespace SoundFile {
 
@@ -115,8 +117,25 @@ void ListView::dropEvent(QDropEvent *event)
 {
     ListView *source = qobject_cast<ListView*>(event->source());
     if (source && source != this) {
-        // extract DB::TableRecord from mime data
-        QList<DB::TableRecord*> records = Misc::JsonMimeDataParser::toTableRecordList(event->mimeData());
+        QElapsedTimer timer;
+        timer.start();
+
+        // sound files dragged within this program, no parsing required
+        const Misc::SoundFileMimeData* sound_data = qobject_cast<const Misc::SoundFileMimeData*>(event->mimeData());
+        if(sound_data) {
+            for(int i = 0; i < sound_data->getIds().size(); ++i)
+                addSoundFile(sound_data->getIds()[i], sound_data->getNames()[i], sound_data->getPaths()[i]);
+
+            qDebug() << "NOTIFICATION: Dropped" << sound_data->getIds().size() << "sound files";
+            qDebug() << " > drop:" << timer.nsecsElapsed() / 1e6 << "ms";
+
+            event->setDropAction(Qt::CopyAction);
+            event->accept();
+            return;
+        }
+
+        // extract sound files from mime data
+        QVector<DB::SoundFileRecord> records = Misc::JsonMimeDataParser::toSoundFileRecords(event->mimeData());
 
         // validate parsing
         if(records.size() == 0) {
@@ -125,18 +144,8 @@ void ListView::dropEvent(QDropEvent *event)
         }
 
         // handle extracted data
-        foreach(DB::TableRecord* rec, records) {
-            if(rec->index == DB::SOUND_FILE) {
-                DB::SoundFileRecord* sound_rec = (DB::SoundFileRecord*) rec;
-                addSoundFile(sound_rec->id, sound_rec->name, sound_rec->path);
-            }
-        }
-
-        // delete temp records
-        while(records.size() > 0) {
-            delete records[0];
-            records.pop_front();
-        }
+        foreach(DB::SoundFileRecord const& rec, records)
+            addSoundFile(rec.id, rec.name, rec.path);
 
         event->setDropAction(Qt::CopyAction);
         event->accept();
@@ -146,6 +155,10 @@ void ListView::dropEvent(QDropEvent *event)
 void ListView::addSoundFile(DB::SoundFileRecord *rec)
 {
     addSoundFile(rec->id, rec->name, rec->path);
+
+    // weight is shown as default when editing it
+    QModelIndex idx = model_->index(model_->rowCount()-1, 0);
+    model_->setData(idx, QVariant(rec->weight), Qt::UserRole + 1);
 }
 
 void ListView::onSoundFileAboutToBeDeleted(DB::SoundFileRecord *)
@@ -165,25 +178,22 @@ void ListView::addSoundFile(int id, const QString &name, const QString &path)
 
 void ListView::performDrag()
 {
-    QList<DB::TableRecord*> records;
+    QElapsedTimer timer;
+    timer.start();
+
+    // ids only, JSON gets created if a target of another program asks for text
+    Misc::SoundFileMimeData* mime_data = new Misc::SoundFileMimeData;
     foreach(QModelIndex idx, selectionModel()->selectedIndexes()) {
-        DB::SoundFileRecord* temp_rec = new DB::SoundFileRecord;
-        temp_rec->id = model_->data(model_->index(idx.row(), 0), Qt::UserRole).toInt();
-        temp_rec->name = model_->data(model_->index(idx.row(), 0)).toString();
-        temp_rec->path = model_->data(model_->index(idx.row(), 1)).toString();
-        records.append(temp_rec);
+        mime_data->append(
+            model_->data(model_->index(idx.row(), 0), Qt::UserRole).toInt(),
+            model_->data(model_->index(idx.row(), 0)).toString(),
+            model_->data(model_->index(idx.row(), 1)).toString()
+        );
     }
 
-    if(records.size() == 0)
+    if(mime_data->getIds().size() == 0) {
+        delete mime_data;
         return;
-
-    // create QMimeData
-    QMimeData* mime_data = Misc::JsonMimeDataParser::toJsonMimeData(records);
-
-    // delete temporary TableRecords
-    while(records.size() > 0) {
-        delete records[0];
-        records.pop_front();
     }
 
     // create Drag
@@ -191,6 +201,9 @@ void ListView::performDrag()
     drag->setMimeData(mime_data);
     drag->setPixmap(*Resources::PX_SOUND_FILE_DRAG);
 
+    qDebug() << "NOTIFICATION: Started drag of" << mime_data->getIds().size() << "sound files";
+    qDebug() << " > drag start:" << timer.nsecsElapsed() / 1e6 << "ms";
+
     // will block until drag done
     drag->exec(Qt::CopyAction);
 }
@@ -1,5 +1,7 @@
 #include "master_view.h"
 
+#include <QInputDialog>
+
 namespace SoundFile {
 
 MasterView::MasterView(QList<DB::SoundFileRecord*> const& sound_files, QWidget *parent)
@@ -31,6 +33,29 @@ void MasterView::onDeleteAction()
     emit deleteSoundFileRequested(id);
 }
 
+void MasterView::onSetWeightAction()
+{
+    QModelIndexList selection = this->selectionModel()->selectedIndexes();
+    if(selection.size() == 0)
+        return;
+
+    QModelIndex idx = model_->index(selection.first().row(), 0);
+    int id = model_->data(idx, Qt::UserRole).toInt();
+    double weight = model_->data(idx, Qt::UserRole + 1).toDouble();
+
+    bool ok = false;
+    weight = QInputDialog::getDouble(
+        this, tr("Set Weight"),
+        tr("Relative probability in weighted playback:"),
+        weight, 0, 1000, 2, &ok
+    );
+    if(!ok)
+        return;
+
+    model_->setData(idx, QVariant(weight), Qt::UserRole + 1);
+    emit soundFileWeightChangeRequested(id, weight);
+}
+
 void MasterView::initContextMenu()
 {
     setContextMenuPolicy(Qt::CustomContextMenu);
@@ -44,6 +69,9 @@ void MasterView::initContextMenu()
     actions.append(new QAction(tr("Delete"), context_menu_));
     connect(actions.back(), SIGNAL(triggered()),
             this, SLOT(onDeleteAction()));
+    actions.append(new QAction(tr("Set Weight..."), context_menu_));
+    connect(actions.back(), SIGNAL(triggered()),
+            this, SLOT(onSetWeightAction()));
 
     context_menu_->addActions(actions);
 }
@@ -16,12 +16,14 @@ public:
 
 signals:
     void deleteSoundFileRequested(int id);
+    void soundFileWeightChangeRequested(int id, double weight);
 
 public slots:
 
 protected slots:
     void showCustomContextMenu(const QPoint&);
     void onDeleteAction();
+    void onSetWeightAction();
 
 protected:
     virtual void initContextMenu();
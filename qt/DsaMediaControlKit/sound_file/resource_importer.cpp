@@ -3,29 +3,108 @@
 #include <QFileDialog>
 #include <QHBoxLayout>
 #include <QDebug>
-#include <QDirIterator>
 #include <QDir>
 
+// number of paths buffered between scan and category stage
+#define IMPORT_QUEUE_SIZE 1024
+// number of SoundFiles handed to the GUI thread at once
+#define IMPORT_BATCH_SIZE 250
+// number of batches waiting to be written at most
+#define IMPORT_BATCHES_IN_FLIGHT 4
+
 namespace SoundFile {
 
 ResourceImporter::ResourceImporter(DB::Model::ResourceDirTableModel* model, QObject *parent)
     : QObject(parent)
     , model_(model)
+    , context_()
+    , scan_thread_()
+    , category_thread_()
+    , import_timer_()
+    , scanned_(0)
+    , categorized_(0)
+    , imported_(0)
+    , scan_finished_(false)
+{
+    qRegisterMetaType<QList<DB::SoundFile> >("QList<DB::SoundFile>");
+}
+
+ResourceImporter::~ResourceImporter()
 {
+    if(context_)
+        context_->cancel();
+    stopThreads();
 }
 
 void ResourceImporter::parseFolder(const QUrl &url, const DB::ResourceDirRecord& resource_dir)
 {
-    QList<DB::SoundFile> files;
-    if(url.isValid() && url.isLocalFile())
-    {
-        QString base_dir = url.toLocalFile();
-        QDirIterator it(base_dir, QStringList() << "*.mp3" << "*.wma" << "*.wav", QDir::Files, QDirIterator::Subdirectories);
-        while (it.hasNext())
-            files.append(DB::SoundFile(QFileInfo(it.next()), resource_dir));
+    if(isImporting()) {
+        emit statusMessageUpdated(tr("An import is already running."));
+        return;
     }
-    emit folderImported(files);
-    emit folderImported();
+
+    if(!url.isValid() || !url.isLocalFile()) {
+        emit folderImported();
+        return;
+    }
+
+    scanned_ = 0;
+    categorized_ = 0;
+    imported_ = 0;
+    scan_finished_ = false;
+    import_timer_.start();
+
+    context_ = QSharedPointer<ImportContext>(new ImportContext(IMPORT_QUEUE_SIZE, IMPORT_BATCHES_IN_FLIGHT));
+
+    // scan stage
+    ScanWorker* scan_worker = new ScanWorker(url.toLocalFile(), context_);
+    scan_thread_ = new QThread(this);
+    scan_worker->moveToThread(scan_thread_);
+
+    connect(scan_thread_, SIGNAL(started()),
+            scan_worker, SLOT(run()));
+    connect(scan_worker, SIGNAL(progressChanged(int)),
+            this, SLOT(onScanProgressChanged(int)));
+    connect(scan_worker, SIGNAL(finished(int)),
+            this, SLOT(onScanFinished(int)));
+    connect(scan_worker, SIGNAL(finished(int)),
+            scan_thread_, SLOT(quit()));
+    connect(scan_thread_, SIGNAL(finished()),
+            scan_worker, SLOT(deleteLater()));
+    connect(scan_thread_, SIGNAL(finished()),
+            scan_thread_, SLOT(deleteLater()));
+
+    // category stage
+    CategoryWorker* category_worker = new CategoryWorker(resource_dir, context_, IMPORT_BATCH_SIZE);
+    category_thread_ = new QThread(this);
+    category_worker->moveToThread(category_thread_);
+
+    connect(category_thread_, SIGNAL(started()),
+            category_worker, SLOT(run()));
+    connect(category_worker, SIGNAL(progressChanged(int)),
+            this, SLOT(onCategoryProgressChanged(int)));
+    connect(category_worker, SIGNAL(batchReady(QList<DB::SoundFile> const&)),
+            this, SLOT(onBatchReady(QList<DB::SoundFile> const&)));
+    connect(category_worker, SIGNAL(finished()),
+            this, SLOT(onCategoryFinished()));
+    connect(category_worker, SIGNAL(finished()),
+            category_thread_, SLOT(quit()));
+    connect(category_thread_, SIGNAL(finished()),
+            category_worker, SLOT(deleteLater()));
+    connect(category_thread_, SIGNAL(finished()),
+            category_thread_, SLOT(deleteLater()));
+
+    emit importRunning(true);
+    emit progressChanged(0, 0);
+    updateStatus();
+
+    category_thread_->start();
+    scan_thread_->start();
+}
+
+bool ResourceImporter::isImporting() const
+{
+    return !context_.isNull();
 }
 
 void ResourceImporter::startBrowseFolder(bool)
@@ -38,19 +117,121 @@ void ResourceImporter::startBrowseFolder(bool)
     }
 }
 
+void ResourceImporter::cancelImport()
+{
+    if(!context_)
+        return;
+
+    context_->cancel();
+    emit statusMessageUpdated(tr("Cancelling import..."));
+}
+
+void ResourceImporter::onScanProgressChanged(int scanned)
+{
+    scanned_ = scanned;
+    updateStatus();
+}
+
+void ResourceImporter::onScanFinished(int scanned)
+{
+    scanned_ = scanned;
+    scan_finished_ = true;
+    updateStatus();
+}
+
+void ResourceImporter::onCategoryProgressChanged(int categorized)
+{
+    categorized_ = categorized;
+    updateStatus();
+}
+
+void ResourceImporter::onBatchReady(const QList<DB::SoundFile>& batch)
+{
+    if(!context_)
+        return;
+
+    if(!context_->isCancelled()) {
+        // receivers write batch to DB
+        emit soundFilesParsed(batch);
+        imported_ += batch.size();
+    }
+
+    // allow category stage to hand out next batch
+    context_->batch_slots.release();
+
+    int files_per_sec = 0;
+    if(import_timer_.elapsed() > 0)
+        files_per_sec = (int) (imported_ / (import_timer_.elapsed() / 1000.0f));
+
+    // 100 is reserved for finished import
+    int progress = qMin((int) (imported_ / (float) qMax(scanned_, 1) * 100), 99);
+
+    emit progressChanged(progress, files_per_sec);
+    updateStatus();
+}
+
+void ResourceImporter::onCategoryFinished()
+{
+    if(!context_)
+        return;
+
+    bool cancelled = context_->isCancelled();
+    context_.clear();
+
+    int files_per_sec = 0;
+    if(import_timer_.elapsed() > 0)
+        files_per_sec = (int) (imported_ / (import_timer_.elapsed() / 1000.0f));
+
+    qDebug() << "NOTIFICATION: folder import finished";
+    qDebug() << " > scanned:" << scanned_ << "categorized:" << categorized_ << "imported:" << imported_;
+    qDebug() << " > duration (ms):" << import_timer_.elapsed();
+    qDebug() << " > cancelled:" << cancelled;
+
+    if(cancelled)
+        emit statusMessageUpdated(tr("Import cancelled after %1 files.").arg(imported_));
+    else
+        emit statusMessageUpdated(tr("Imported %1 files.").arg(imported_));
+
+    emit progressChanged(100, files_per_sec);
+    emit importRunning(false);
+    emit folderImported();
+}
+
 DB::ResourceDirRecord* ResourceImporter::createOrGetResourceDir(const QUrl &url)
 {
     if(url.isValid() && url.isLocalFile()) {
         QString base_dir = url.toLocalFile();
         DB::ResourceDirRecord* rec = model_->getResourceDirByPath(base_dir);
-        if(rec == 0) {
-            model_->addResourceDirRecord(QFileInfo(base_dir));
-            rec = model_->getResourceDirByPath(base_dir);
-        }
+        if(rec == 0)
+            rec = model_->addResourceDirRecord(QFileInfo(base_dir));
         return rec;
     }
 
     return 0;
 }
 
+void ResourceImporter::updateStatus()
+{
+    if(!context_)
+        return;
+
+    QString scan_state = scan_finished_ ? tr("done") : tr("running");
+    emit statusMessageUpdated(
+        tr("Import: scanned %1 (%2), categorized %3, imported %4")
+            .arg(scanned_).arg(scan_state).arg(categorized_).arg(imported_)
+    );
+}
+
+void ResourceImporter::stopThreads()
+{
+    if(scan_thread_) {
+        scan_thread_->quit();
+        scan_thread_->wait();
+    }
+    if(category_thread_) {
+        category_thread_->quit();
+        category_thread_->wait();
+    }
+}
+
 } // namespace SoundFile
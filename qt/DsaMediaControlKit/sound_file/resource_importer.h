@@ -4,14 +4,24 @@
 #include <QObject>
 #include <QStringList>
 #include <QFileInfo>
+#include <QThread>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <QSharedPointer>
 
 #include "db/sound_file.h"
 #include "db/model/resource_dir_table_model.h"
+#include "import_worker.h"
 
 namespace SoundFile {
 
 /*
  * Class for importing soundfile ressources.
+ * Import runs as a pipeline: a ScanWorker walks the folder and a
+ * CategoryWorker computes category paths, each on its own thread.
+ * Parsed SoundFiles are handed out in batches on the GUI thread
+ * (see soundFilesParsed), so they can be written to the DB
+ * while the scan is still running.
 */
 class ResourceImporter : public QObject
 {
@@ -19,23 +29,44 @@ class ResourceImporter : public QObject
 
 public:
     explicit ResourceImporter(DB::Model::ResourceDirTableModel* model, QObject *parent = 0);
+    ~ResourceImporter();
 
     /*
-     * Imports folder with given url.
-     * Siganls folderImported(QList<DB::SoundFile> const&)
-     * when import is finished.
+     * Starts import of folder with given url.
+     * Signals soundFilesParsed(QList<DB::SoundFile> const&) per batch
+     * and folderImported() when import is finished.
     */
     void parseFolder(QUrl const& url, const DB::ResourceDirRecord& resource_dir);
 
+    /* Returns true while a folder import is running */
+    bool isImporting() const;
+
 signals:
-    void folderImported(QList<DB::SoundFile> const&);
+    /*
+     * Batch of parsed SoundFiles.
+     * Receivers have to process the batch before returning,
+     * pipeline will wait for batches to be processed.
+    */
+    void soundFilesParsed(QList<DB::SoundFile> const&);
     void folderImported();
     void statusMessageUpdated(QString const&);
+    void progressChanged(int progress, int files_per_sec);
+    void importRunning(bool);
 
 public slots:
     /* triggers folder import dialog and parsing of soundfiles */
     void startBrowseFolder(bool);
 
+    /* stops running import, already imported files are kept */
+    void cancelImport();
+
+private slots:
+    void onScanProgressChanged(int scanned);
+    void onScanFinished(int scanned);
+    void onCategoryProgressChanged(int categorized);
+    void onBatchReady(QList<DB::SoundFile> const&);
+    void onCategoryFinished();
+
 private:
     /*
      * Returns the ResourceDirRecord corresponding to given url.
@@ -44,8 +75,22 @@ private:
     */
     DB::ResourceDirRecord* createOrGetResourceDir(const QUrl& url);
 
+    /* emits per stage progress as status message */
+    void updateStatus();
+
+    /* stops and waits for worker threads */
+    void stopThreads();
+
     DB::Model::ResourceDirTableModel* model_;
 
+    QSharedPointer<ImportContext> context_;
+    QPointer<QThread> scan_thread_;
+    QPointer<QThread> category_thread_;
+    QElapsedTimer import_timer_;
+    int scanned_;
+    int categorized_;
+    int imported_;
+    bool scan_finished_;
 };
 
 } // namespace SoundFile